@@ -0,0 +1,89 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_COMMON_NEIGHBORINDEX_H_
+#define INCLUDE_SCRIMMAGE_COMMON_NEIGHBORINDEX_H_
+
+#include <scrimmage/common/ID.h>
+
+#include <Eigen/Dense>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace scrimmage {
+
+/*! \brief an entity found by a neighbor query */
+struct Neighbor {
+    ID id;
+    double dist_sq; // squared distance from the query position
+};
+
+/*! \brief called with each entity found by a neighbor query */
+using NeighborFunc = std::function<void(const ID &id, double dist_sq)>;
+
+/*! \brief Interface for the spatial index used behind RTree's neighbor
+ * queries. The index is filled with add() after each clear(), and the queries
+ * may then be called from several threads at once.
+ */
+class NeighborIndex {
+ public:
+    virtual ~NeighborIndex() {}
+
+    virtual void init(int size) = 0;
+    virtual void clear() = 0;
+    virtual void add(const Eigen::Vector3d &pos, const ID &id) = 0;
+
+    virtual void nearest_n_neighbors(const Eigen::Vector3d &pos,
+                                     std::vector<ID> &neighbors, unsigned int n,
+                                     int self_id = -1, int team_id = -1) = 0;
+    virtual void neighbors_in_range(const Eigen::Vector3d &pos,
+                                    std::vector<ID> &neighbors, double dist,
+                                    int self_id = -1, int team_id = -1) = 0;
+
+    virtual void nearest_n_neighbors(const Eigen::Vector3d &pos,
+                                     std::vector<Neighbor> &neighbors, unsigned int n,
+                                     int self_id = -1, int team_id = -1) = 0;
+    virtual void neighbors_in_range(const Eigen::Vector3d &pos,
+                                    std::vector<Neighbor> &neighbors, double dist,
+                                    int self_id = -1, int team_id = -1) = 0;
+    virtual void for_each_in_range(const Eigen::Vector3d &pos, double dist,
+                                   const NeighborFunc &func,
+                                   int self_id = -1, int team_id = -1) = 0;
+};
+
+using NeighborIndexPtr = std::shared_ptr<NeighborIndex>;
+
+} // namespace scrimmage
+
+#endif // INCLUDE_SCRIMMAGE_COMMON_NEIGHBORINDEX_H_
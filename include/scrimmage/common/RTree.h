@@ -34,9 +34,11 @@
 #define INCLUDE_SCRIMMAGE_COMMON_RTREE_H_
 
 #include <scrimmage/common/ID.h>
+#include <scrimmage/common/NeighborIndex.h>
 
 #include <Eigen/Dense>
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <memory>
@@ -49,6 +51,7 @@
 #include <boost/geometry/index/parameters.hpp> // for dynamic_rstar definition
 #include <boost/geometry/geometries/point.hpp> // for model::point
 #include <boost/geometry/index/indexable.hpp>
+#include <boost/geometry/index/equal_to.hpp>
 
 namespace boost { namespace geometry { namespace index {
 // boost/geometry/index/rtree.hpp
@@ -63,27 +66,172 @@ typedef boost::geometry::index::rtree<
     point_id_t,
     boost::geometry::index::dynamic_rstar,
     boost::geometry::index::indexable<point_id_t>,
-    std::equal_to<point_id_t>,
+    boost::geometry::index::equal_to<point_id_t>,
     std::allocator<point_id_t>> rtree_t;
 
 typedef std::shared_ptr<rtree_t> rtreePtr;
 
+/*! \brief a read-only view of one entity's neighbors in a batched list */
+class NeighborList {
+ public:
+    NeighborList() = default;
+    NeighborList(const Neighbor *first, const Neighbor *last) :
+        first_(first), last_(last) {}
+
+    const Neighbor *begin() const { return first_; }
+    const Neighbor *end() const { return last_; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+
+ protected:
+    const Neighbor *first_ = nullptr;
+    const Neighbor *last_ = nullptr;
+};
+
 class RTree {
  public:
+    /*! \brief time spent keeping the trees up to date with update()/commit() */
+    struct UpdateStats {
+        uint64_t rebuilds = 0;  // commits that bulk loaded the trees
+        uint64_t updates = 0;   // commits that moved entities one at a time
+        uint64_t moved = 0;     // entities moved one at a time
+        double rebuild_time = 0;
+        double update_time = 0;
+    };
+
     void init(int size);
     void clear();
 
+    /*! \brief insert an entity immediately */
     void add(Eigen::Vector3d &pos, const ID &id);
+
+    /*! \brief Set the position of an entity that will be applied by the next
+     * commit(). Entities that don't move are left alone.
+     */
+    void update(const Eigen::Vector3d &pos, const ID &id);
+    /*! \brief remove an entity at the next commit() */
+    void remove(const ID &id);
+    /*! \brief Apply the changes since the last commit. If more than the
+     * rebuild fraction of the entities changed, the trees are bulk loaded
+     * (packed) instead of moving the entities one at a time.
+     */
+    void commit();
+
+    void set_rebuild_fraction(double rebuild_fraction) {
+        rebuild_fraction_ = rebuild_fraction;
+    }
+    const UpdateStats &update_stats() const { return update_stats_; }
+
+    /*! \brief Answer the neighbor queries with another index instead of the
+     * boost trees. Set it before init().
+     */
+    void set_index(NeighborIndexPtr index) { index_ = index; }
+    NeighborIndexPtr index() const { return index_; }
+
     void nearest_n_neighbors(const Eigen::Vector3d &pos,
                              std::vector<ID> &neighbors, unsigned int n,
                              int self_id = -1, int team_id = -1);
     void neighbors_in_range(const Eigen::Vector3d &pos,
                             std::vector<ID> &neighbors, double dist,
                             int self_id = -1, int team_id = -1);
+
+    /*! \brief Same as above, but each neighbor comes with its squared
+     * distance from pos. The vector is cleared and refilled, so a caller
+     * that keeps it between queries does not allocate once it has grown.
+     */
+    void nearest_n_neighbors(const Eigen::Vector3d &pos,
+                             std::vector<Neighbor> &neighbors, unsigned int n,
+                             int self_id = -1, int team_id = -1);
+    void neighbors_in_range(const Eigen::Vector3d &pos,
+                            std::vector<Neighbor> &neighbors, double dist,
+                            int self_id = -1, int team_id = -1);
+
+    /*! \brief call func(id, squared distance) for each entity within dist
+     * of pos, without storing the results
+     */
+    void for_each_in_range(const Eigen::Vector3d &pos, double dist,
+                           const NeighborFunc &func,
+                           int self_id = -1, int team_id = -1);
+
+    /*! \brief Ask for the neighbors of every entity within radius to be
+     * computed in one batch each time step. Returns the id to pass to
+     * neighbor_list(). Equal radii share an id.
+     */
+    int register_neighbor_radius(double radius);
+    size_t num_neighbor_radii() const { return radii_.size(); }
+
+    /*! \brief Compute the neighbor lists of every entity for the registered
+     * radii. begin_neighbor_lists() returns the number of entities n, then
+     * compute_neighbor_lists() is called over disjoint ranges covering
+     * [0, n), from at most num_threads threads, and finish_neighbor_lists()
+     * puts the lists together. All of the buffers are kept between calls.
+     */
+    size_t begin_neighbor_lists(int num_threads);
+    void compute_neighbor_lists(size_t begin, size_t end, int thread_id);
+    void finish_neighbor_lists();
+    /*! \brief all three of the above on the calling thread */
+    void compute_neighbor_lists();
+
+    /*! \brief Get the entities within the radius with radius_id of the
+     * entity with entity_id, not including itself. Returns false if the lists
+     * haven't been computed since the tree last changed or the entity wasn't
+     * in the tree, in which case the caller should query the tree instead.
+     */
+    bool neighbor_list(int radius_id, int entity_id, NeighborList &list) const;
+
+    /*! \brief Make neighbor_list() return false until the lists are computed
+     * again. The lists hold the neighbors at the positions the tree was built
+     * with, so SimControl calls this once the entities have moved.
+     */
+    void invalidate_neighbor_lists() { lists_valid_ = false; }
+
  protected:
+    rtreePtr &team_tree(int team_id);
+    /*! \brief the tree to search for team_id (-1 for all), or nullptr */
+    rtree_t *query_tree(int team_id);
+    void rebuild();
+    /*! \brief the index of id's value in entries_, -1 if it isn't there */
+    int &entry_index(int id);
+
     rtreePtr rtree_;
     std::map<int, rtreePtr> rtree_team_;
     int size_ = 0;
+
+    // The value each entity was inserted with, packed densely, and its
+    // index by entity id (negative ids in entry_of_neg_id_[-id - 1]). The
+    // vectors keep their memory when the tree is cleared and refilled.
+    std::vector<point_id_t> entries_;
+    std::vector<int> entry_of_id_;
+    std::vector<int> entry_of_neg_id_;
+
+    // changes waiting for commit()
+    std::vector<point_id_t> added_;
+    std::vector<point_id_t> removed_;
+    std::vector<std::pair<point_id_t, point_id_t>> moved_; // old, new
+    std::vector<point_id_t> scratch_;
+
+    double rebuild_fraction_ = 0.5;
+    UpdateStats update_stats_;
+
+    NeighborIndexPtr index_;
+
+    // Batched neighbor lists. The lists of each radius are stored in
+    // compressed sparse row form: the neighbors of row i are
+    // lists_[r][offsets_[r][i]] to lists_[r][offsets_[r][i + 1]].
+    struct ThreadLists {
+        std::vector<uint32_t> rows;                // in the order computed
+        std::vector<std::vector<uint32_t>> counts; // per radius, per row
+        std::vector<std::vector<Neighbor>> hits;   // per radius
+        std::vector<Neighbor> scratch;
+    };
+
+    std::vector<double> radii_;
+    std::vector<point_id_t> rows_;
+    std::vector<int> row_of_id_;  // indexed by entity id, -1 if no row
+    std::vector<std::vector<uint32_t>> offsets_;
+    std::vector<std::vector<Neighbor>> lists_;
+    std::vector<ThreadLists> thread_lists_;
+    bool lists_valid_ = false;
 };
 
 typedef std::shared_ptr<RTree> RTreePtr;
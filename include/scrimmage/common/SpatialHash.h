@@ -0,0 +1,132 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_COMMON_SPATIALHASH_H_
+#define INCLUDE_SCRIMMAGE_COMMON_SPATIALHASH_H_
+
+#include <scrimmage/common/NeighborIndex.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex> // NOLINT
+#include <vector>
+
+namespace scrimmage {
+
+/*! \brief Uniform grid neighbor index, stored as a hash table of cells.
+ *
+ * The entities are counting-sorted into buckets when the first query after
+ * an add() is made, so a rebuild is O(N) and reuses the same buffers every
+ * step. Range queries only visit the cells that overlap the query's bounding
+ * box. If cell_size is not positive, the cell size follows the most common
+ * range query radius (rounded up to a power of two) seen since the last
+ * rebuild.
+ */
+class SpatialHash : public NeighborIndex {
+ public:
+    explicit SpatialHash(double cell_size = 0);
+
+    void init(int size) override;
+    void clear() override;
+    void add(const Eigen::Vector3d &pos, const ID &id) override;
+
+    void nearest_n_neighbors(const Eigen::Vector3d &pos,
+                             std::vector<ID> &neighbors, unsigned int n,
+                             int self_id = -1, int team_id = -1) override;
+    void neighbors_in_range(const Eigen::Vector3d &pos,
+                            std::vector<ID> &neighbors, double dist,
+                            int self_id = -1, int team_id = -1) override;
+
+    void nearest_n_neighbors(const Eigen::Vector3d &pos,
+                             std::vector<Neighbor> &neighbors, unsigned int n,
+                             int self_id = -1, int team_id = -1) override;
+    void neighbors_in_range(const Eigen::Vector3d &pos,
+                            std::vector<Neighbor> &neighbors, double dist,
+                            int self_id = -1, int team_id = -1) override;
+    void for_each_in_range(const Eigen::Vector3d &pos, double dist,
+                           const NeighborFunc &func,
+                           int self_id = -1, int team_id = -1) override;
+
+    double cell_size() const { return cell_size_; }
+
+ protected:
+    using Cell = std::array<int64_t, 3>;
+
+    struct Entry {
+        Eigen::Vector3d pos;
+        ID id;
+        Cell cell;
+    };
+
+    void build();
+    void ensure_built();
+    Cell cell(const Eigen::Vector3d &pos) const;
+    size_t bucket(const Cell &cell) const;
+
+    /*! \brief calls func(entry, squared distance) for every entry within
+     * dist of pos that passes the team filter
+     */
+    template <class Func>
+    void visit_range(const Eigen::Vector3d &pos, double dist,
+                     int team_id, Func &&func) const;
+
+    /*! \brief calls func(id, squared distance) for the n nearest entities,
+     * closest first
+     */
+    template <class Func>
+    void visit_nearest(const Eigen::Vector3d &pos, unsigned int n,
+                       int self_id, int team_id, Func &&func);
+
+    void record_radius(double dist);
+
+    bool adaptive_;
+    double cell_size_;
+
+    std::vector<Entry> entries_;       // in the order they were added
+    std::vector<Entry> sorted_;        // grouped by bucket
+    std::vector<uint32_t> bucket_start_;
+    size_t mask_ = 0;
+    Eigen::Vector3d min_;
+    Eigen::Vector3d max_;
+
+    std::atomic<bool> dirty_{false};
+    std::mutex build_mutex_;
+
+    // log2 histogram of range query radii for the adaptive cell size
+    static constexpr int num_radius_bins = 64;
+    std::array<std::atomic<uint32_t>, num_radius_bins> radius_counts_;
+};
+
+} // namespace scrimmage
+
+#endif // INCLUDE_SCRIMMAGE_COMMON_SPATIALHASH_H_
@@ -0,0 +1,128 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_COMMON_TASKSCHEDULER_H_
+#define INCLUDE_SCRIMMAGE_COMMON_TASKSCHEDULER_H_
+
+#include <condition_variable> // NOLINT
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex> // NOLINT
+#include <string>
+#include <thread> // NOLINT
+#include <vector>
+
+namespace scrimmage {
+
+/*! \brief A persistent pool of threads that runs parallel phases over an
+ * index range [0, n).
+ *
+ * Each phase is split into chunks that are dealt to per-thread deques.
+ * A thread drains its own deque from the front and then steals from the back
+ * of the other deques. The calling thread takes part in the phase and
+ * run() only returns once every chunk has completed, so a phase acts as a
+ * barrier.
+ */
+class TaskScheduler {
+ public:
+    /*! \brief called with a chunk [begin, end) and the id of the thread
+     * running it (0 is the calling thread), returns false on failure
+     */
+    using RangeFunc = std::function<bool(size_t begin, size_t end, int thread_id)>;
+
+    struct PhaseStats {
+        uint64_t count = 0;
+        double wall_time = 0; // seconds spent in the phase
+        double busy_time = 0; // seconds spent by all threads running chunks
+        double speedup() const {
+            return wall_time > 0 ? busy_time / wall_time : 1.0;
+        }
+    };
+
+    TaskScheduler() = default;
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+    ~TaskScheduler();
+
+    /*! \brief start num_threads - 1 workers (the caller is the last thread).
+     * A chunk_size of 0 picks a size that gives each thread several chunks.
+     */
+    void start(int num_threads, size_t chunk_size = 0);
+    void stop();
+
+    int num_threads() const { return static_cast<int>(queues_.size()); }
+
+    /*! \brief run func over [0, n) and wait for it to finish. Returns false
+     * if func returned false for any chunk.
+     */
+    bool run(const std::string &phase, size_t n, const RangeFunc &func);
+
+    const std::map<std::string, PhaseStats> &phase_stats() const { return stats_; }
+    void clear_stats() { stats_.clear(); }
+
+ protected:
+    struct WorkQueue {
+        std::mutex mutex;
+        size_t front = 0; // next chunk taken by the owning thread
+        size_t back = 0;  // one past the last chunk, thieves take from here
+        double busy_time = 0;
+        bool success = true;
+    };
+
+    void worker(int id);
+    void drain(int id);
+    bool pop(int id, size_t &chunk);
+    bool steal(int id, size_t &chunk);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t epoch_ = 0;
+    int busy_workers_ = 0;
+    bool stop_ = false;
+
+    // current phase, only written while no worker is busy
+    const RangeFunc *func_ = nullptr;
+    size_t n_ = 0;
+    size_t chunk_size_ = 0;
+    size_t phase_chunk_size_ = 1;
+
+    std::map<std::string, PhaseStats> stats_;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_COMMON_TASKSCHEDULER_H_
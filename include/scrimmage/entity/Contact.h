@@ -36,9 +36,13 @@
 #include <scrimmage/common/ID.h>
 #include <scrimmage/pubsub/Message.h>
 
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <string>
+#include <vector>
 #include <iosfwd>
 
 namespace scrimmage_proto {
@@ -64,7 +68,8 @@ class Contact {
     template <class T>
     std::unordered_map<std::string, MessagePtr<T>> get_properties(std::string name = "") {
         std::unordered_map<std::string, MessagePtr<T>> out;
-        for (auto &kv : properties_) {
+        if (!properties_) return out;
+        for (auto &kv : *properties_) {
             if (name == "" || kv.first.find(name) != std::string::npos) {
                 auto property_cast =
                     std::dynamic_pointer_cast<Message<T>>(kv.second);
@@ -91,6 +96,11 @@ class Contact {
     bool active();
     double radius() { return radius_; }
 
+    /*! \brief Contacts share their properties with their copies. Setting the
+     * properties replaces them for this contact only.
+     */
+    void set_properties(const std::unordered_map<std::string, MessageBasePtr> &properties);
+
     friend std::ostream& operator<<(std::ostream& os, const Contact& c);
 
  protected:
@@ -100,10 +110,134 @@ class Contact {
     scrimmage_proto::ContactVisualPtr contact_visual_;
     bool active_ = true;
     double radius_ = 0;
-    std::unordered_map<std::string, MessageBasePtr> properties_;
+    std::shared_ptr<const std::unordered_map<std::string, MessageBasePtr>> properties_;
+};
+
+/*! \brief Table of contacts keyed by entity id.
+ *
+ * The contacts are stored in a vector of slots, so iterating over them is a
+ * scan of contiguous memory. A slot keeps its position until the contact is
+ * erased, after which the slot's generation is incremented and it may be
+ * reused. Ids below max_direct_id are mapped to slots through a vector, so
+ * lookups don't hash. The interface follows std::unordered_map<int, Contact>,
+ * except that iteration is in slot order.
+ */
+class ContactMap {
+ public:
+    using key_type = int;
+    using mapped_type = Contact;
+    using value_type = std::pair<int, Contact>;
+    using size_type = size_t;
+
+    static constexpr int max_direct_id = 1 << 20;
+
+    /*! \brief refers to the slot of a contact, becomes invalid when the
+     * contact is erased even if the slot is reused
+     */
+    struct Handle {
+        int slot = -1;
+        uint32_t generation = 0;
+    };
+
+    template <class Map, class Value>
+    class Iterator {
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ContactMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value *;
+        using reference = Value &;
+
+        Iterator() = default;
+        Iterator(Map *map, int slot) : map_(map), slot_(slot) { skip_unused(); }
+
+        // iterator to const_iterator
+        template <class M, class V>
+        Iterator(const Iterator<M, V> &other) : map_(other.map_), slot_(other.slot_) {}
+
+        reference operator*() const { return map_->slots_[slot_]; }
+        pointer operator->() const { return &map_->slots_[slot_]; }
+
+        Iterator &operator++() {
+            slot_++;
+            skip_unused();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        bool operator==(const Iterator &other) const { return slot_ == other.slot_; }
+        bool operator!=(const Iterator &other) const { return slot_ != other.slot_; }
+
+        int slot() const { return slot_; }
+
+     protected:
+        template <class M, class V> friend class Iterator;
+
+        void skip_unused() {
+            const int n = static_cast<int>(map_->used_.size());
+            while (slot_ < n && !map_->used_[slot_]) slot_++;
+        }
+
+        Map *map_ = nullptr;
+        int slot_ = 0;
+    };
+
+    using iterator = Iterator<ContactMap, value_type>;
+    using const_iterator = Iterator<const ContactMap, const value_type>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, num_slots()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, num_slots()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+    void reserve(size_t n);
+
+    iterator find(int id);
+    const_iterator find(int id) const;
+    size_t count(int id) const { return slot(id) >= 0 ? 1 : 0; }
+
+    /*! \brief throws std::out_of_range if there is no contact with the id */
+    Contact &at(int id);
+    const Contact &at(int id) const;
+
+    /*! \brief inserts a default contact if there is no contact with the id */
+    Contact &operator[](int id);
+
+    size_t erase(int id);
+    iterator erase(const_iterator it);
+
+    /*! \brief slot of the contact with the given id, -1 if there is none */
+    int slot(int id) const;
+    /*! \brief number of slots, including unused ones */
+    int num_slots() const { return static_cast<int>(slots_.size()); }
+
+    Handle handle(int id) const;
+    /*! \brief returns nullptr if the contact was erased */
+    Contact *get(const Handle &handle);
+
+ protected:
+    void set_slot(int id, int slot);
+
+    std::vector<value_type> slots_;
+    std::vector<uint32_t> generations_;
+    std::vector<char> used_;
+    std::vector<int> free_slots_;
+    size_t size_ = 0;
+
+    std::vector<int> id_to_slot_;
+    std::unordered_map<int, int> sparse_id_to_slot_;
 };
 
-using ContactMap = std::unordered_map<int, Contact>;
 using ContactMapPtr = std::shared_ptr<ContactMap>;
 } // namespace scrimmage
 #endif // INCLUDE_SCRIMMAGE_ENTITY_CONTACT_H_
@@ -140,6 +140,9 @@ class Entity : public std::enable_shared_from_this<Entity> {
     void set_random(RandomPtr random);
     RandomPtr random();
 
+    /*! \brief if set before init(), the entity's state is kept in the store */
+    void set_state_store(StateStorePtr state_store);
+
     Contact::Type type();
 
     void set_visual_changed(bool visual_changed);
@@ -205,6 +208,7 @@ class Entity : public std::enable_shared_from_this<Entity> {
     RandomPtr random_;
 
     StatePtr state_;
+    StateStorePtr state_store_;
     std::unordered_map<std::string, MessageBasePtr> properties_;
     std::unordered_map<std::string, SensorPtr> sensors_;
 
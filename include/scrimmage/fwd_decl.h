@@ -58,13 +58,16 @@ using AutonomyPtr = std::shared_ptr<Autonomy>;
 class State;
 using StatePtr = std::shared_ptr<State>;
 
+class StateStore;
+using StateStorePtr = std::shared_ptr<StateStore>;
+
 class ID;
 
 class Random;
 using RandomPtr = std::shared_ptr<Random>;
 
 class Contact;
-using ContactMap = std::unordered_map<int, Contact>;
+class ContactMap;
 using ContactMapPtr = std::shared_ptr<ContactMap>;
 
 class FileSearch;
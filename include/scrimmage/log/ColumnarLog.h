@@ -0,0 +1,167 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_LOG_COLUMNARLOG_H_
+#define INCLUDE_SCRIMMAGE_LOG_COLUMNARLOG_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace scrimmage_proto {
+class Frame;
+}
+
+namespace scrimmage {
+
+/*! \brief The frames of a chunk of a columnar log, one array per field.
+ *
+ * The contacts of frame i are rows [row_begin[i], row_begin[i + 1]).
+ *
+ * On disk a columnar log (frames.col) is:
+ *
+ *   "SCRCOL02"
+ *   chunks, each: uint32 num_frames, uint32 num_rows, every column in
+ *     Column order (time and row_begin have num_frames and num_frames + 1
+ *     values, the others have num_rows values) and a footer, the chunk's
+ *     ChunkInfo followed by "SCRCOLCH"
+ *   the index, a ChunkInfo per chunk
+ *   uint64 index offset, uint64 number of chunks, "SCRCOLIX"
+ *
+ * Values are stored in the byte order of the machine that wrote the log.
+ * A column's offset only depends on the chunk's frame and row counts, so a
+ * reader can seek straight to the columns it needs. If the run ended
+ * without closing the log, the reader rebuilds the index from the chunk
+ * footers.
+ */
+struct ColumnarChunk {
+    enum Column {
+        TIME = 0, ROW_BEGIN,
+        ID, SUB_SWARM_ID, TEAM_ID, TYPE, ACTIVE,
+        POS_X, POS_Y, POS_Z,
+        VEL_X, VEL_Y, VEL_Z,
+        QUAT_W, QUAT_X, QUAT_Y, QUAT_Z,
+        NUM_COLUMNS
+    };
+
+    std::vector<double> time;
+    std::vector<uint32_t> row_begin;
+    std::vector<int32_t> id;
+    std::vector<int32_t> sub_swarm_id;
+    std::vector<int32_t> team_id;
+    std::vector<uint8_t> type; // scrimmage_proto::ContactType
+    std::vector<uint8_t> active;
+    std::vector<double> pos_x, pos_y, pos_z;
+    std::vector<double> vel_x, vel_y, vel_z;
+    std::vector<double> quat_w, quat_x, quat_y, quat_z;
+
+    size_t num_frames() const { return time.size(); }
+    size_t num_rows() const { return id.size(); }
+
+    void clear();
+    void add_frame(const scrimmage_proto::Frame &frame);
+    std::shared_ptr<scrimmage_proto::Frame> frame(size_t i) const;
+
+    /*! \brief the size of one value of the column */
+    static size_t value_size(Column column);
+    /*! \brief the offset of a column from the start of its chunk */
+    static uint64_t column_offset(Column column, uint32_t num_frames, uint32_t num_rows);
+};
+
+/*! \brief where a chunk is and the times of its first and last frames */
+struct ColumnarChunkInfo {
+    double t_begin;
+    double t_end;
+    uint64_t offset;
+    uint32_t num_frames;
+    uint32_t num_rows;
+};
+
+/*! \brief Writes frames into chunks that each span chunk_duration seconds
+ * of sim time. A chunk is written and flushed when a frame past its end
+ * arrives, and the index when the log is closed.
+ */
+class ColumnarLogWriter {
+ public:
+    ~ColumnarLogWriter();
+
+    bool open(const std::string &filename, double chunk_duration);
+    bool write_frame(const scrimmage_proto::Frame &frame);
+    bool close();
+
+ protected:
+    bool write_chunk();
+
+    std::ofstream output_;
+    double chunk_duration_ = 10;
+    double chunk_end_ = 0;
+    ColumnarChunk chunk_;
+    std::vector<ColumnarChunkInfo> index_;
+};
+
+/*! \brief Reads the chunks, columns or frames of a columnar log */
+class ColumnarLogReader {
+ public:
+    bool open(const std::string &filename);
+
+    const std::vector<ColumnarChunkInfo> &chunks() const { return index_; }
+
+    /*! \brief the first chunk with a frame at or after t, or chunks().size() */
+    size_t find_chunk(double t) const;
+
+    /*! \brief read one column of a chunk, T has to match the column's type */
+    template <class T>
+    bool read_column(size_t chunk, ColumnarChunk::Column column, std::vector<T> &values) {
+        if (sizeof(T) != ColumnarChunk::value_size(column)) return false;
+        values.resize(num_values(chunk, column));
+        return read_values(chunk, column, values.data());
+    }
+
+    bool read_chunk(size_t chunk, ColumnarChunk &columns);
+
+    /*! \brief the first frame at or after t, or nullptr */
+    std::shared_ptr<scrimmage_proto::Frame> read_frame(double t);
+
+ protected:
+    size_t num_values(size_t chunk, ColumnarChunk::Column column) const;
+    bool read_values(size_t chunk, ColumnarChunk::Column column, void *values);
+    bool read_index();
+    void scan_chunks();
+
+    std::ifstream input_;
+    std::vector<ColumnarChunkInfo> index_;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_LOG_COLUMNARLOG_H_
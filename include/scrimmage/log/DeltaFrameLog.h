@@ -0,0 +1,145 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_LOG_DELTAFRAMELOG_H_
+#define INCLUDE_SCRIMMAGE_LOG_DELTAFRAMELOG_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace scrimmage_proto {
+class Frame;
+}
+
+namespace scrimmage {
+
+/*! \brief Shared by DeltaFrameWriter and DeltaFrameReader.
+ *
+ * Frames are grouped into blocks of keyframe_interval frames. The first
+ * frame of a block is a keyframe: each contact's state is encoded against
+ * zero. In the frames after it, each value is encoded against the contact's
+ * value in the last frame it appeared in. The id, team, type and active
+ * flag are only written when they change. A block is compressed with zlib
+ * and can be decoded on its own.
+ *
+ * In the lossless mode (quantum = 0) a value is stored as the XOR of its
+ * bits with the previous value, which is small when little changed. In the
+ * quantized mode positions and velocities are rounded to multiples of
+ * quantum, orientations to multiples of quat_quantum, and the difference
+ * of the multiples is stored. Values more than 2^52 multiples from zero
+ * are clamped, and NaN and the infinities have codes of their own.
+ *
+ * On disk (frames.delta):
+ *   "SCRDLT01", float64 quantum, float64 quat_quantum
+ *   blocks, each: uint32 raw size, uint32 compressed size,
+ *     uint32 number of frames, float64 time of the keyframe, zlib data
+ */
+class DeltaFrameCodec {
+ public:
+    static constexpr int num_values = 10; // position, velocity, orientation
+
+    /*! \brief true if data, the start of a file, is a frames.delta header */
+    static bool is_delta_log(const void *data, size_t size);
+
+ protected:
+    struct Entry {
+        int sub_swarm_id = 0;
+        int team_id = 0;
+        int type = 0;
+        bool active = false;
+        uint64_t values[num_values] = {}; // bits or quantized multiples
+    };
+
+    double quantum_ = 0;
+    double quat_quantum_ = 0;
+    std::unordered_map<int, Entry> prev_;
+};
+
+class DeltaFrameWriter : public DeltaFrameCodec {
+ public:
+    ~DeltaFrameWriter();
+
+    /*! \brief a quantum of 0 encodes the frames losslessly */
+    bool open(const std::string &filename, unsigned int keyframe_interval,
+              double quantum = 0, double quat_quantum = 1.0e-6);
+    bool write_frame(const scrimmage_proto::Frame &frame);
+    bool close();
+
+ protected:
+    bool write_block();
+
+    std::ofstream output_;
+    unsigned int keyframe_interval_ = 100;
+    unsigned int num_frames_ = 0;
+    double keyframe_time_ = 0;
+    std::string block_;
+    std::string compressed_;
+};
+
+class DeltaFrameReader : public DeltaFrameCodec {
+ public:
+    DeltaFrameReader();
+    ~DeltaFrameReader();
+
+    bool open(const std::string &filename);
+
+    /*! \brief decode the next frame, returns false at the end of the file
+     * or if a block is corrupt or truncated
+     */
+    bool next();
+
+    /*! \brief the frame decoded by the last call to next() */
+    const scrimmage_proto::Frame &frame() const { return *frame_; }
+
+    bool clean_eof() const { return eof_ && !error_; }
+    void rewind();
+
+ protected:
+    bool read_block();
+    bool decode_frame();
+
+    std::ifstream input_;
+    std::streampos first_block_ = 0;
+    std::string block_;
+    std::string compressed_;
+    size_t offset_ = 0;
+    unsigned int frames_left_ = 0;
+    bool eof_ = false;
+    bool error_ = false;
+    std::unique_ptr<scrimmage_proto::Frame> frame_;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_LOG_DELTAFRAMELOG_H_
@@ -0,0 +1,144 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_LOG_FRAMELOGPOLICY_H_
+#define INCLUDE_SCRIMMAGE_LOG_FRAMELOGPOLICY_H_
+
+#include <scrimmage/fwd_decl.h>
+#include <scrimmage/log/FrameLogger.h>
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace scrimmage {
+
+/*! \brief Decides which of the simulation's frames are logged.
+ *
+ * Without a trigger every frame is logged. Otherwise a frame is logged when
+ * any of the enabled triggers fires:
+ *
+ *   rate: frames are logged rate times per second of sim time, independent
+ *     of the simulation's dt
+ *   dead band: a contact moved more than dead_band meters since the last
+ *     logged frame, or a contact was added, removed, activated or changed
+ *     its type. The whole frame is logged, including the contacts that
+ *     stayed within their band, since a frame can't hold only some of the
+ *     contacts.
+ *   events: an event was added with add_event. The frames within pre seconds
+ *     before the event and post seconds after it are logged.
+ *
+ * The first frame and frames that are forced (e.g., the last one) are
+ * always logged. Frames are logged whole or not at all.
+ *
+ * To log the frames before an event, the contacts of skipped frames are
+ * passed to buffer_frame, which keeps a FrameSnapshot of them for pre
+ * seconds. The snapshots are returned by take_buffered_frames when an event
+ * logs the current frame, so that only the frames that are logged are
+ * built. A frame logged by another trigger discards the buffered frames, so
+ * that frames are always logged in order.
+ */
+class FrameLogPolicy {
+ public:
+    struct Stats {
+        uint64_t frames = 0;  // frames offered to the policy
+        uint64_t logged = 0;  // frames logged, including buffered ones
+    };
+
+    void set_rate(double rate) { rate_ = rate; }
+    void set_dead_band(double dead_band) { dead_band_ = dead_band; }
+    void set_event_window(double pre, double post);
+    void set_events_enabled(bool enabled) { events_enabled_ = enabled; }
+
+    /*! \brief whether any trigger is enabled, if not every frame is logged */
+    bool enabled() const;
+
+    /*! \brief whether skipped frames should be passed to buffer_frame */
+    bool buffering() const { return events_enabled_ && pre_ > 0; }
+
+    /*! \brief an event happened at time t */
+    void add_event(double t);
+
+    /*! \brief whether to log the frame of the contacts at time t */
+    bool update(double t, ContactMap &contacts, bool force = false);
+
+    /*! \brief keep a snapshot of the contacts of a frame that update
+     * decided to skip
+     */
+    void buffer_frame(double t, ContactMap &contacts);
+
+    /*! \brief the buffered frames within pre seconds of the event that
+     * caused the last frame to be logged, oldest first. Pass them back to
+     * recycle_frames once they are logged, to reuse their storage.
+     */
+    std::vector<FrameSnapshot> take_buffered_frames();
+    void recycle_frames(std::vector<FrameSnapshot> &frames);
+
+    const Stats &stats() const { return stats_; }
+
+ protected:
+    struct LoggedContact {
+        Eigen::Vector3d pos;
+        int type;
+        bool active;
+    };
+
+    bool moved(ContactMap &contacts);
+    void set_logged(ContactMap &contacts);
+    void recycle(FrameSnapshot &frame);
+
+    double rate_ = 0;
+    double dead_band_ = 0;
+    bool events_enabled_ = false;
+    double pre_ = 0;
+    double post_ = 0;
+
+    bool first_ = true;
+    double rate_start_ = 0;
+    uint64_t rate_count_ = 0;
+    bool event_pending_ = false;
+    double event_time_ = 0;
+    double post_end_time_ = -1;
+
+    std::unordered_map<int, LoggedContact> logged_contacts_;
+    std::deque<FrameSnapshot> buffered_;
+    std::vector<FrameSnapshot> flushed_;
+    std::vector<FrameSnapshot> spare_; // snapshots kept for their storage
+    Stats stats_;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_LOG_FRAMELOGPOLICY_H_
@@ -0,0 +1,171 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_LOG_FRAMELOGGER_H_
+#define INCLUDE_SCRIMMAGE_LOG_FRAMELOGGER_H_
+
+#include <scrimmage/fwd_decl.h>
+
+#include <condition_variable> // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex> // NOLINT
+#include <string>
+#include <thread> // NOLINT
+#include <vector>
+
+namespace scrimmage_proto {
+class Frame;
+}
+
+namespace scrimmage {
+
+/*! \brief The kinematics of the contacts at one time. Copying them is much
+ * cheaper than building a frame, which can be done later or on another
+ * thread. The contacts vector keeps its storage when a snapshot is reused.
+ */
+struct FrameSnapshot {
+    struct ContactSnapshot {
+        int id;
+        int sub_swarm_id;
+        int team_id;
+        int type;
+        bool active;
+        double pos[3];
+        double vel[3];
+        double quat[4]; // x, y, z, w
+    };
+
+    double time = 0;
+    std::vector<ContactSnapshot> contacts;
+    std::shared_ptr<scrimmage_proto::Frame> frame; // used as is if set
+    bool save = true;    // write the frame to the log
+    bool display = true; // hand the frame to the GUI
+
+    /*! \brief copy the contacts at time t, to be saved and displayed */
+    void capture(double t, ContactMap &contacts);
+
+    /*! \brief the frame, built from the contacts unless it is set */
+    std::shared_ptr<scrimmage_proto::Frame> to_frame() const;
+};
+
+/*! \brief Sends frames from a background thread.
+ *
+ * The simulation thread copies the contacts' kinematics into a slot of a
+ * bounded single producer, single consumer ring. The logging thread builds
+ * each frame from its slot and, as the slot asks, writes it to the log and
+ * hands it to the GUI through the Interface. Slots keep their storage, so
+ * a steady state run doesn't allocate on the simulation thread.
+ *
+ * When the ring is full the policy decides what happens to a new frame:
+ * BLOCK waits for a free slot, DROP discards the frame and DECIMATE discards
+ * it and only queues every other frame from then on, doubling the interval
+ * each time the ring fills and halving it once the ring is mostly empty.
+ */
+class FrameLogger {
+ public:
+    enum class Policy {BLOCK, DROP, DECIMATE};
+
+    struct Stats {
+        uint64_t frames = 0;    // frames queued
+        uint64_t dropped = 0;   // frames discarded because the ring was full
+        uint64_t decimated = 0; // frames skipped by the decimation interval
+        uint64_t failed = 0;    // frames that failed to reach the GUI
+        double wait_time = 0;   // seconds the simulation thread was blocked
+    };
+
+    FrameLogger() = default;
+    FrameLogger(const FrameLogger &) = delete;
+    FrameLogger &operator=(const FrameLogger &) = delete;
+    ~FrameLogger();
+
+    /*! \brief parse "block", "drop" or "decimate" */
+    static bool parse_policy(const std::string &str, Policy &policy);
+
+    void start(InterfacePtr interface, size_t queue_size, Policy policy);
+
+    /*! \brief send the queued frames and stop the logging thread */
+    void stop();
+
+    bool running() const { return thread_.joinable(); }
+
+    /*! \brief queue a frame of the contacts at time t, to be saved to the
+     * log and/or displayed. The caller must keep the contacts from being
+     * modified until it returns.
+     */
+    void log_frame(double t, ContactMap &contacts,
+                   bool save = true, bool display = true);
+
+    /*! \brief queue a frame that was already built */
+    void log_frame(std::shared_ptr<scrimmage_proto::Frame> frame);
+
+    /*! \brief queue a snapshot, whose frame is built by the logging thread.
+     * The snapshot is swapped with a free slot, so it is left with that
+     * slot's storage.
+     */
+    void log_frame(FrameSnapshot &snapshot);
+
+    /*! \brief only complete once the logger is stopped */
+    const Stats &stats() const { return stats_; }
+
+ protected:
+    using Snapshot = FrameSnapshot;
+
+    /*! \brief the slot at head_, or nullptr if the frame is dropped */
+    Snapshot *next_slot();
+    /*! \brief hand the slot at head_ to the logging thread */
+    void push_slot();
+
+    void worker();
+    void send(const Snapshot &snapshot);
+
+    InterfacePtr interface_;
+    Policy policy_ = Policy::BLOCK;
+    std::vector<Snapshot> slots_;
+
+    // head_ is only advanced by the simulation thread and tail_ by the
+    // logging thread. A slot in [tail_, head_) is owned by the logging thread.
+    std::mutex mutex_;
+    std::condition_variable not_empty_cv_;
+    std::condition_variable not_full_cv_;
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+
+    uint64_t interval_ = 1;
+    uint64_t offered_ = 0;
+    Stats stats_;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_LOG_FRAMELOGGER_H_
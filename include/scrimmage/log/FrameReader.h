@@ -0,0 +1,144 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_LOG_FRAMEREADER_H_
+#define INCLUDE_SCRIMMAGE_LOG_FRAMEREADER_H_
+
+#include <scrimmage/log/DeltaFrameLog.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+
+namespace scrimmage_proto {
+class Frame;
+}
+
+namespace scrimmage {
+
+/*! \brief Reads the frames of a frames.bin file one at a time.
+ *
+ * The file is memory mapped and each frame is parsed when it is reached,
+ * into a frame that is reused, so reading a log takes the same memory no
+ * matter how long it is. Unlike Log::parse, no ContactMap is built.
+ *
+ * A compressed frames.delta file (see DeltaFrameLog.h) is detected by its
+ * header and read through a DeltaFrameReader. Its offsets count frames
+ * instead of bytes, and seeking decodes the frames from the start.
+ *
+ * \code
+ * FrameReader reader;
+ * if (reader.open(log_dir + "/frames.bin")) {
+ *     for (const scrimmage_proto::Frame &frame : reader) { ... }
+ * }
+ * \endcode
+ */
+class FrameReader {
+ public:
+    FrameReader();
+    FrameReader(const FrameReader &) = delete;
+    FrameReader &operator=(const FrameReader &) = delete;
+    ~FrameReader();
+
+    bool open(const std::string &filename);
+    void close();
+
+    /*! \brief parse the next frame, returns false at the end of the file or
+     * if the next frame is corrupt or truncated
+     */
+    bool next();
+
+    /*! \brief step over the next frame without parsing it */
+    bool skip();
+
+    /*! \brief the frame parsed by the last call to next() */
+    const scrimmage_proto::Frame &frame() const {
+        if (delta_) return delta_->frame();
+        return *frame_;
+    }
+
+    /*! \brief true if the whole file was read without errors */
+    bool clean_eof() const {
+        return delta_ ? delta_->clean_eof() : offset_ == size_ && !error_;
+    }
+
+    /*! \brief the offset of the next frame, which can be passed to seek() */
+    size_t offset() const { return offset_; }
+    void seek(size_t offset);
+    void rewind() { seek(0); }
+
+    size_t size() const { return size_; }
+
+    class iterator {
+     public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = scrimmage_proto::Frame;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        explicit iterator(FrameReader *reader = nullptr) : reader_(reader) {
+            ++(*this);
+        }
+        reference operator*() const { return reader_->frame(); }
+        pointer operator->() const { return &reader_->frame(); }
+        iterator &operator++() {
+            if (reader_ && !reader_->next()) reader_ = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator &other) const { return reader_ == other.reader_; }
+        bool operator!=(const iterator &other) const { return reader_ != other.reader_; }
+
+     protected:
+        FrameReader *reader_;
+    };
+
+    /*! \brief iterate over the frames from the current offset */
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+ protected:
+    bool read_size(uint32_t &size);
+
+    int fd_ = -1;
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    bool error_ = false;
+    std::unique_ptr<scrimmage_proto::Frame> frame_;
+    std::unique_ptr<DeltaFrameReader> delta_;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_LOG_FRAMEREADER_H_
@@ -57,6 +57,9 @@ class ContactVisual;
 
 namespace scrimmage {
 
+class ColumnarLogWriter;
+class DeltaFrameWriter;
+
 class Log {
  public:
     using ZeroCopyInputStreamPtr = std::shared_ptr<google::protobuf::io::ZeroCopyInputStream>;
@@ -88,6 +91,9 @@ class Log {
     bool parse_frames(std::string filename,
                       ZeroCopyInputStreamPtr input);
 
+    /*! \brief parse the frames of a frames.delta file */
+    bool parse_compressed_frames(std::string filename);
+
     bool parse_shapes(std::string filename,
                       ZeroCopyInputStreamPtr input);
 
@@ -112,6 +118,18 @@ class Log {
 
     bool save_frame(const std::shared_ptr<scrimmage_proto::Frame> &frame);
 
+    /*! \brief Also save frames to frames.col, in chunks of chunk_duration
+     * seconds (see ColumnarLog.h). Call after init().
+     */
+    bool enable_columnar_frames(double chunk_duration);
+
+    /*! \brief Save frames to frames.delta, delta encoded and compressed
+     * (see DeltaFrameLog.h), instead of frames.bin. A quantum of 0 is
+     * lossless. Call after init(), before any frames are saved.
+     */
+    bool enable_compressed_frames(unsigned int keyframe_interval,
+                                  double quantum, double quat_quantum);
+
     bool save_shapes(const scrimmage_proto::Shapes &shapes);
 
     bool save_utm_terrain(const std::shared_ptr<scrimmage_proto::UTMTerrain> &utm_terrain);
@@ -121,6 +139,8 @@ class Log {
     // bool save_messages();
 
     std::string frames_filename();
+    std::string columnar_frames_filename();
+    std::string compressed_frames_filename();
     std::string shapes_filename();
     std::string utm_terrain_filename();
     std::string contact_visual_filename();
@@ -143,6 +163,8 @@ class Log {
     std::string utm_terrain_name_ = "utm_terrain.bin";
     std::string contact_visual_name_ = "contact_visual.bin";
     std::string msgs_name_ = "msgs.bin";
+    std::string columnar_frames_name_ = "frames.col";
+    std::string compressed_frames_name_ = "frames.delta";
 
     int frames_fd_;
     int shapes_fd_;
@@ -160,6 +182,8 @@ class Log {
     ZeroCopyOutputStreamPtr utm_terrain_output_;
     ZeroCopyOutputStreamPtr contact_visual_output_;
     ZeroCopyOutputStreamPtr msgs_output_;
+    std::shared_ptr<ColumnarLogWriter> columnar_frames_output_;
+    std::shared_ptr<DeltaFrameWriter> compressed_frames_output_;
 
     std::list<Frame> scrimmage_frames_;
     std::list<std::shared_ptr<scrimmage_proto::Frame> > frames_;
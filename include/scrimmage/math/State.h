@@ -43,12 +43,25 @@
 
 namespace scrimmage {
 
+class StateStore;
+
+/*! \brief Kinematic state of an entity.
+ *
+ * By default the values are stored in the State itself. When the State is
+ * added to a StateStore, it becomes a view of a slot in the store's arrays
+ * and the accessors read and write that slot instead.
+ */
 class State {
  public:
     State();
     State(Eigen::Vector3d _pos, Eigen::Vector3d _vel,
           Eigen::Vector3d _ang_vel, Quaternion _quat);
 
+    /*! \brief copies the values, the copy is never bound to a store */
+    State(const State &other);
+    /*! \brief copies the values, keeping this state's storage */
+    State &operator=(const State &other);
+
     virtual ~State();
 
     Eigen::Vector3d &pos();
@@ -111,10 +124,22 @@ class State {
     }
 
  protected:
-    Eigen::Vector3d pos_;
-    Eigen::Vector3d vel_;
-    Eigen::Vector3d ang_vel_;
-    Quaternion quat_;
+    friend class StateStore;
+    void use_local_storage();
+
+    // storage used while the state is not in a StateStore
+    Eigen::Vector3d local_pos_;
+    Eigen::Vector3d local_vel_;
+    Eigen::Vector3d local_ang_vel_;
+    Quaternion local_quat_;
+
+    Eigen::Vector3d *pos_;
+    Eigen::Vector3d *vel_;
+    Eigen::Vector3d *ang_vel_;
+    Quaternion *quat_;
+
+    std::shared_ptr<StateStore> store_;
+    int slot_ = -1;
 
  public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
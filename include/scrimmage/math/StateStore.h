@@ -0,0 +1,133 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_MATH_STATESTORE_H_
+#define INCLUDE_SCRIMMAGE_MATH_STATESTORE_H_
+
+#include <scrimmage/common/ID.h>
+#include <scrimmage/math/Quaternion.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex> // NOLINT
+#include <vector>
+
+namespace scrimmage {
+
+class State;
+
+/*! \brief Structure-of-arrays storage for the kinematic state of every
+ * entity in the simulation.
+ *
+ * Positions, velocities, angular velocities and orientations are kept in
+ * separate contiguous arrays, indexed by a dense slot. A State that has been
+ * added to the store is a view of its slot, so plugins keep using the State
+ * API while sweeps over the whole swarm (e.g., rebuilding the RTree) scan the
+ * arrays linearly. The arrays are allocated in fixed size blocks so that a
+ * slot never moves once it has been handed out.
+ */
+class StateStore : public std::enable_shared_from_this<StateStore> {
+ public:
+    static constexpr int block_size = 256;
+
+    StateStore() = default;
+    StateStore(const StateStore &) = delete;
+    StateStore &operator=(const StateStore &) = delete;
+
+    /*! \brief move the values of state into a free slot. Afterwards the
+     * state reads and writes the slot.
+     */
+    void add(State &state, const ID &id);
+
+    /*! \brief copy the slot's values back into state and free the slot */
+    void remove(State &state);
+
+    /*! \brief number of slots handed out, including free ones */
+    int size() const { return num_slots_; }
+    int num_active() const { return num_slots_ - static_cast<int>(free_slots_.size()); }
+
+    bool active(int slot) const { return block(slot).active[offset(slot)]; }
+    const ID &id(int slot) const { return block(slot).id[offset(slot)]; }
+    Eigen::Vector3d &pos(int slot) { return block(slot).pos[offset(slot)]; }
+    Eigen::Vector3d &vel(int slot) { return block(slot).vel[offset(slot)]; }
+    Eigen::Vector3d &ang_vel(int slot) { return block(slot).ang_vel[offset(slot)]; }
+    Quaternion &quat(int slot) { return block(slot).quat[offset(slot)]; }
+
+    /*! \brief call func(slot) for every slot in use, in slot order */
+    template <class Func>
+    void for_each(Func &&func) {
+        for (int b = 0; b < static_cast<int>(blocks_.size()); b++) {
+            const Block &blk = *blocks_[b];
+            const int n = std::min(block_size, num_slots_ - b * block_size);
+            for (int i = 0; i < n; i++) {
+                if (blk.active[i]) func(b * block_size + i);
+            }
+        }
+    }
+
+ protected:
+    friend class State;
+
+    struct Block {
+        std::array<Eigen::Vector3d, block_size> pos;
+        std::array<Eigen::Vector3d, block_size> vel;
+        std::array<Eigen::Vector3d, block_size> ang_vel;
+        std::array<Quaternion, block_size> quat;
+        std::array<ID, block_size> id;
+        std::array<bool, block_size> active;
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+    Block &block(int slot) { return *blocks_[slot / block_size]; }
+    const Block &block(int slot) const { return *blocks_[slot / block_size]; }
+    static int offset(int slot) { return slot % block_size; }
+
+    /*! \brief called by a bound State when it is destroyed */
+    void release(int slot);
+
+    std::vector<std::unique_ptr<Block>> blocks_;
+    std::vector<int> free_slots_;
+    int num_slots_ = 0;
+
+    // States can be destroyed from any thread
+    std::mutex mutex_;
+};
+
+using StateStorePtr = std::shared_ptr<StateStore>;
+
+} // namespace scrimmage
+
+#endif // INCLUDE_SCRIMMAGE_MATH_STATESTORE_H_
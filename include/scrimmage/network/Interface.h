@@ -36,6 +36,7 @@
 #include <scrimmage/fwd_decl.h>
 #include <scrimmage/proto/Frame.pb.h>
 #include <scrimmage/proto/Visual.pb.h>
+#include <scrimmage/proto/Shape.pb.h>
 #include <scrimmage/proto/GUIControl.pb.h>
 
 #if ENABLE_GRPC == 1
@@ -72,6 +73,11 @@ class Interface {
     bool send_frame(double time, ContactMapPtr &contacts);
 
     bool send_frame(std::shared_ptr<scrimmage_proto::Frame> &frame);
+    /*! \brief the halves of send_frame: write the frame to the log, and
+     * hand it to the GUI
+     */
+    void save_frame(std::shared_ptr<scrimmage_proto::Frame> &frame);
+    bool display_frame(std::shared_ptr<scrimmage_proto::Frame> &frame);
 
     bool send_utm_terrain(std::shared_ptr<scrimmage_proto::UTMTerrain> &utm_terrain);
     bool send_contact_visual(std::shared_ptr<scrimmage_proto::ContactVisual> &cv);
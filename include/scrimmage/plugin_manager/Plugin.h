@@ -39,6 +39,7 @@
 #include <scrimmage/pubsub/PubSub.h>
 #include <scrimmage/pubsub/Subscriber.h>
 
+#include <atomic>
 #include <unordered_set>
 #include <unordered_map>
 #include <memory>
@@ -124,11 +125,30 @@ class Plugin : public std::enable_shared_from_this<Plugin> {
 
     void set_pubsub(PubSubPtr pubsub) { pubsub_ = pubsub; }
 
-    std::list<SubscriberBasePtr> subs() { return subs_; }
+    std::list<SubscriberBasePtr> &subs() { return subs_; }
+
+    /*! \brief Set by the plugin's subscribers when they are sent a message,
+     * so that plugins without new messages don't visit their subscribers.
+     */
+    void set_pending_msgs() {
+        if (!pending_msgs_.load(std::memory_order_relaxed)) {
+            pending_msgs_.store(true, std::memory_order_release);
+        }
+    }
+    bool has_pending_msgs() const {
+        return pending_msgs_.load(std::memory_order_acquire);
+    }
+
+    /*! \brief clear the pending flag, returning whether it was set */
+    bool take_pending_msgs() {
+        return pending_msgs_.load(std::memory_order_relaxed) &&
+            pending_msgs_.exchange(false, std::memory_order_acquire);
+    }
 
     void set_time(const std::shared_ptr<Time> &time) { time_ = time; }
     // cppcheck-suppress passedByValue
     void set_time(std::shared_ptr<const Time> time) { time_ = time; }
+    const std::shared_ptr<const Time> &get_time() const { return time_; }
 
     void draw_shape(scrimmage_proto::ShapePtr s);
     bool print_err_on_exit = true;
@@ -150,6 +170,7 @@ class Plugin : public std::enable_shared_from_this<Plugin> {
 
  private:
     std::list<scrimmage_proto::ShapePtr> shapes_;
+    std::atomic<bool> pending_msgs_{false};
 
  public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -34,9 +34,11 @@
 #define INCLUDE_SCRIMMAGE_PLUGINS_AUTONOMY_BOIDS_BOIDS_H_
 
 #include <scrimmage/autonomy/Autonomy.h>
+#include <scrimmage/common/RTree.h>
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace scrimmage {
 namespace autonomy {
@@ -60,12 +62,16 @@ class Boids : public scrimmage::Autonomy{
     double fov_el_;
     double fov_az_;
     double comms_range_;
+    int comms_radius_id_ = -1;
     double minimum_team_range_;
     double minimum_nonteam_range_;
     double sphere_of_influence_;
 
     Eigen::Vector3d goal_;
 
+    // reused between steps so the neighbor query doesn't allocate
+    std::vector<Neighbor> neighbors_;
+
     // variable io
     int io_vel_x_idx_ = 0;
     int io_vel_y_idx_ = 0;
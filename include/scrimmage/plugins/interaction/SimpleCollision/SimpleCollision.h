@@ -36,10 +36,15 @@
 #include <scrimmage/simcontrol/EntityInteraction.h>
 #include <scrimmage/entity/Entity.h>
 #include <scrimmage/pubsub/Publisher.h>
+#include <scrimmage/common/SpatialHash.h>
+#include <scrimmage/common/TaskScheduler.h>
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace scrimmage {
 namespace interaction {
@@ -64,6 +69,15 @@ class SimpleCollision : public scrimmage::EntityInteraction {
     bool enable_non_team_collisions_;
     bool init_alt_deconflict_;
 
+    // Broadphase over the current positions. The hash holds the index of
+    // each entity in ents_ in place of its entity id.
+    std::vector<scrimmage::Entity *> ents_;
+    std::unique_ptr<scrimmage::SpatialHash> hash_;
+    scrimmage::TaskScheduler scheduler_;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> thread_pairs_;
+    std::vector<std::vector<scrimmage::Neighbor>> thread_neighbors_;
+    std::vector<std::pair<uint32_t, uint32_t>> pairs_;
+
     scrimmage::PublisherPtr team_collision_pub_;
     scrimmage::PublisherPtr non_team_collision_pub_;
 };
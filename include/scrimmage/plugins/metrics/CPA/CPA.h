@@ -35,9 +35,15 @@
 
 #include <scrimmage/metrics/Metrics.h>
 #include <scrimmage/common/CSV.h>
+#include <scrimmage/common/SpatialHash.h>
+#include <scrimmage/common/TaskScheduler.h>
+
+#include <Eigen/Dense>
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <limits>
 
@@ -73,10 +79,34 @@ class CPA : public scrimmage::Metrics {
  protected:
     std::map<std::string, std::string> params_;
 
+    /*! \brief update the CPA of entities [begin, end) against the entities
+     * that could get closer than their current CPA
+     */
+    void update_cpa(size_t begin, size_t end, int thread_id, double t);
+
     // Entity Num: CPA, Closest Entity, Time
     std::map<int, CPAData> cpa_map_;
     CSV csv_;
     bool initialized_ = false;
+
+    // Find the closest approach between time steps assuming the entities
+    // move in straight lines. Otherwise, only the positions at each time
+    // step are compared.
+    bool continuous_ = true;
+
+    // The entities this step, sorted by id. The spatial hash holds the
+    // index into these vectors in place of the entity id.
+    std::vector<int> ids_;
+    std::vector<Eigen::Vector3d> pos_;
+    std::vector<Eigen::Vector3d> prev_pos_;
+    std::vector<CPAData *> data_;
+    std::unordered_map<int, Eigen::Vector3d> last_pos_;
+    double last_t_ = 0;
+    double max_displacement_ = 0;
+
+    std::unique_ptr<SpatialHash> hash_;
+    TaskScheduler scheduler_;
+    std::vector<std::vector<Neighbor>> thread_neighbors_;
  private:
 };
 
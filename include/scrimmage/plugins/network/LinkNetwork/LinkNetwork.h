@@ -0,0 +1,114 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_PLUGINS_NETWORK_LINKNETWORK_LINKNETWORK_H_
+#define INCLUDE_SCRIMMAGE_PLUGINS_NETWORK_LINKNETWORK_LINKNETWORK_H_
+
+#include <scrimmage/pubsub/Network.h>
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace scrimmage {
+namespace network {
+
+/*! \brief Network that delays messages by modeling each link.
+ *
+ * A published message is serialized onto its node's link at the node's
+ * bandwidth. Messages wait behind the node's earlier messages. Each
+ * subscriber receives the message after the link's latency plus the
+ * propagation delay over the distance between the two entities. In-flight
+ * messages are held in a priority queue keyed on delivery time and are
+ * delivered on the first step at or after that time.
+ */
+class LinkNetwork : public scrimmage::Network {
+ public:
+    bool init(std::map<std::string, std::string> &mission_params,
+              std::map<std::string, std::string> &plugin_params) override;
+
+    size_t num_in_flight() { return in_flight_.size(); }
+
+ protected:
+    bool is_reachable(const scrimmage::PluginPtr &pub_plugin,
+                      const scrimmage::PluginPtr &sub_plugin) override;
+
+    bool is_successful_transmission(const scrimmage::PluginPtr &pub_plugin,
+                                    const scrimmage::PluginPtr &sub_plugin) override;
+
+    void published(const NetworkDevicePtr &pub, MessageQueue &msgs) override;
+
+    bool transmit(const NetworkDevicePtr &pub, const NetworkDevicePtr &sub,
+                  const MessageBasePtr &msg, size_t index) override;
+
+    void routed() override;
+
+    double &link_free_time(const scrimmage::PluginPtr &plugin);
+
+    struct InFlight {
+        double time;
+        uint64_t seq; // keeps messages due at the same time in order
+        NetworkDevicePtr sub;
+        MessageBasePtr msg;
+
+        bool operator>(const InFlight &rhs) const {
+            return time > rhs.time || (time == rhs.time && seq > rhs.seq);
+        }
+    };
+    // min-heap on delivery time
+    std::vector<InFlight> in_flight_;
+    uint64_t seq_ = 0;
+
+    double range_ = -1;
+    double prob_transmit_ = 1;
+    double latency_ = 0;
+    double propagation_speed_ = 0;
+    double bandwidth_ = 0;
+    double msg_bytes_ = 0;
+    double max_backlog_ = -1;
+
+    // When each node's link is done sending its queued messages, indexed by
+    // entity ID (entry 0 is shared by plugins without an entity)
+    std::vector<double> link_free_;
+
+    // The time each message of the current publisher finishes being sent,
+    // or NaN if it was dropped because the link was backed up
+    std::vector<double> sent_time_;
+    Eigen::Vector3d pub_pos_;
+    bool pub_has_pos_ = false;
+};
+} // namespace network
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_PLUGINS_NETWORK_LINKNETWORK_LINKNETWORK_H_
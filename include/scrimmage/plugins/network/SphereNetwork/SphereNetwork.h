@@ -35,8 +35,12 @@
 
 #include <scrimmage/pubsub/Network.h>
 
+#include <cstdint>
+#include <list>
 #include <map>
+#include <random>
 #include <string>
+#include <vector>
 
 namespace scrimmage {
 namespace network {
@@ -45,14 +49,41 @@ class SphereNetwork : public scrimmage::Network {
  public:
     bool init(std::map<std::string, std::string> &mission_params,
                       std::map<std::string, std::string> &plugin_params) override;
+    bool step(std::map<std::string, std::list<NetworkDevicePtr>> &pubs,
+              std::map<std::string, std::list<NetworkDevicePtr>> &subs) override;
  protected:
     bool is_reachable(const scrimmage::PluginPtr &pub_plugin,
                               const scrimmage::PluginPtr &sub_plugin) override;
 
     bool is_successful_transmission(const scrimmage::PluginPtr &pub_plugin,
                                             const scrimmage::PluginPtr &sub_plugin) override;
+    void mark_reachable(const scrimmage::PluginPtr &pub_plugin);
+    double draw_uniform();
+
     double range_;
     double prob_transmit_;
+
+    // Each publishing entity's reachable entity IDs, computed at most once
+    // per step and stored back to back in adj_ (indexed by entity ID)
+    struct Row {
+        uint64_t step = 0;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+    uint64_t step_ = 0;
+    std::vector<Row> rows_;
+    std::vector<int> adj_;
+
+    // marks_[id] == mark_ if entity id is reachable from marked_pub_
+    uint64_t mark_ = 0;
+    int marked_pub_ = -1;
+    std::vector<uint64_t> marks_;
+
+    // Batch mode draws packet drops from its own generator, a block at a time
+    bool batch_ = false;
+    std::mt19937_64 gener_;
+    std::vector<double> uniforms_;
+    size_t next_uniform_ = 0;
 };
 } // namespace network
 } // namespace scrimmage
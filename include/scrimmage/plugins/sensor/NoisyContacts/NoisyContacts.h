@@ -54,6 +54,7 @@ class NoisyContacts : public scrimmage::Sensor {
     std::vector<std::shared_ptr<std::normal_distribution<double>>> orient_noise_;
 
     double max_detect_range_;
+    int radius_id_ = -1;
     double az_thresh_;
     double el_thresh_;
 };
@@ -33,6 +33,7 @@
 #ifndef INCLUDE_SCRIMMAGE_PROTO_PROTOCONVERSIONS_H_
 #define INCLUDE_SCRIMMAGE_PROTO_PROTOCONVERSIONS_H_
 
+#include <scrimmage/entity/Contact.h>
 #include <scrimmage/plugin_manager/Plugin.h>
 
 #include <Eigen/Dense>
@@ -75,6 +76,12 @@ void set(scrimmage_proto::Color *color, int r, int g, int b);
 void set(scrimmage_proto::Color *color, int grayscale);
 void set(scrimmage_proto::Quaternion *dst, Quaternion &src);
 
+/*! \brief Fill in a frame's contact. pos and vel are x, y, z and quat is
+ * x, y, z, w.
+ */
+void set(scrimmage_proto::Contact *dst, const ID &id, Contact::Type type,
+         bool active, const double *pos, const double *vel, const double *quat);
+
 Eigen::Vector3d eigen(const scrimmage_proto::Vector3d &src);
 
 void add_point_color(std::shared_ptr<scrimmage_proto::Shape> s, const scrimmage::Color_t &c);
@@ -0,0 +1,417 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_PUBSUB_ATOMICMESSAGEQUEUE_H_
+#define INCLUDE_SCRIMMAGE_PUBSUB_ATOMICMESSAGEQUEUE_H_
+
+#include <scrimmage/pubsub/MessageBase.h>
+#include <scrimmage/pubsub/MessageQueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread> // NOLINT
+#include <utility>
+
+namespace scrimmage {
+
+/*! \brief Lock-free queue of messages for many producers and one consumer.
+ *
+ * A bounded queue (capacity > 0) is a ring of slots, each carrying a
+ * sequence number. A producer claims the next ticket with a compare and swap
+ * on the tail, moves its message into the ticket's slot and then publishes
+ * it by advancing the slot's sequence number. The consumer claims tickets
+ * from the head the same way. When the ring is full a producer claims the
+ * oldest ticket itself and drops that message, so the queue never holds more
+ * than capacity messages and pushing doesn't allocate. No thread waits for
+ * another: a slot whose producer hasn't finished is left for the next drain,
+ * and a producer that finds the oldest slot unfinished drops its own message.
+ *
+ * An unbounded queue (capacity 0) is a list of fixed size blocks of slots,
+ * claimed with tickets in the same way. The producer that claims the last
+ * slot of a block links in the next one, and only the other producers that
+ * reach the end of the block wait for it. Drained blocks are kept for reuse,
+ * so once a queue has seen its largest burst pushing doesn't allocate.
+ */
+class AtomicMessageQueue {
+ public:
+    AtomicMessageQueue() : head_block_(new Block()), tail_block_(head_block_) {}
+
+    explicit AtomicMessageQueue(size_t capacity) : AtomicMessageQueue() {
+        set_capacity(capacity);
+    }
+
+    AtomicMessageQueue(const AtomicMessageQueue &rhs) : AtomicMessageQueue() {
+        set_capacity(rhs.capacity_);
+        rhs.for_each([&](const MessageBasePtr &msg) {push(msg);});
+    }
+
+    AtomicMessageQueue &operator=(const AtomicMessageQueue &rhs) = delete;
+
+    ~AtomicMessageQueue() {
+        clear();
+        delete_blocks(head_block_);
+        delete_blocks(free_blocks_.load(std::memory_order_acquire));
+    }
+
+    /*! \brief Bound the queue to capacity messages, 0 for unbounded. The
+     * newest queued messages are kept. Not safe to call while other threads
+     * use the queue.
+     */
+    void set_capacity(size_t capacity) {
+        if (capacity == capacity_) return;
+
+        MessageQueue msgs;
+        drain(msgs);
+        reset();
+        capacity_ = capacity;
+
+        // the ring needs two slots to tell a full slot from a free one
+        num_slots_ = capacity > 0 ? std::max<size_t>(capacity, 2) : 0;
+        slots_.reset(num_slots_ > 0 ? new Slot[num_slots_] : nullptr);
+        for (size_t i = 0; i < num_slots_; i++) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        const size_t n = msgs.size();
+        const size_t keep = capacity > 0 ? std::min(n, capacity) : n;
+        for (size_t i = n - keep; i < n; i++) {
+            push(std::move(msgs[i]));
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    /*! \brief add a message, safe to call from any thread */
+    void push(MessageBasePtr msg) {
+        if (capacity_ > 0) {
+            push_ring(std::move(msg));
+        } else {
+            push_blocks(std::move(msg));
+        }
+    }
+
+    /*! \brief Move the queued messages, oldest first, onto the back of msgs.
+     * Only the newest max_size messages are kept and the number dropped,
+     * including the ones a bounded queue overwrote, is returned. Messages
+     * pushed during the drain are left for the next one. Only one thread may
+     * drain a queue at a time.
+     */
+    size_t drain(MessageQueue &msgs,
+                 size_t max_size = std::numeric_limits<size_t>::max()) {
+        const size_t n = claimed();
+        const size_t keep = capacity_ > 0 ? std::min(capacity_, max_size) : max_size;
+        size_t skip = n > keep ? n - keep : 0;
+        size_t dropped = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            MessageBasePtr msg;
+            if (!pop(msg)) break;
+            if (skip > 0) {
+                skip--;
+                dropped++;
+            } else {
+                msgs.push_back(std::move(msg));
+            }
+        }
+
+        // Read last so that messages producers dropped during the drain are
+        // counted now. Any dropped after this leave a newer message queued.
+        if (capacity_ > 0) {
+            dropped += overwritten_.exchange(0, std::memory_order_relaxed);
+        }
+        return dropped;
+    }
+
+    void clear() {
+        const size_t n = claimed();
+        MessageBasePtr msg;
+        for (size_t i = 0; i < n && pop(msg); i++) {
+            msg = nullptr;
+        }
+    }
+
+    /*! \brief the number of queued messages, exact when no thread is pushing */
+    size_t size() const {
+        const size_t n = claimed();
+        return capacity_ > 0 ? std::min(n, capacity_) : n;
+    }
+
+    bool empty() const { return claimed() == 0; }
+
+ protected:
+    // Bounded ring. seq is the ticket the slot is free for or, once the
+    // message is written, that ticket + 1.
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        MessageBasePtr msg;
+    };
+
+    // Unbounded blocks. The ticket of an unbounded queue is
+    // lap * block number + offset, where offset block_cap means the
+    // producer that claimed the block's last slot is linking in the next.
+    static constexpr uint64_t lap = 32;
+    static constexpr uint64_t block_cap = lap - 1;
+
+    struct BlockSlot {
+        std::atomic<bool> written{false};
+        MessageBasePtr msg;
+    };
+
+    struct Block {
+        std::atomic<Block*> next{nullptr};
+        BlockSlot slots[block_cap];
+    };
+
+    bool pop(MessageBasePtr &msg) {
+        return capacity_ > 0 ? pop_ring(msg) : pop_blocks(msg);
+    }
+
+    void push_ring(MessageBasePtr msg) {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots_[pos % num_slots_];
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.msg = std::move(msg);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+            } else if (diff < 0) {
+                // The ring is full, drop the oldest message to make room. If
+                // its producer is still writing it, drop this one instead.
+                MessageBasePtr oldest;
+                if (pop_ring(oldest)) {
+                    overwritten_.fetch_add(1, std::memory_order_relaxed);
+                } else if (static_cast<int64_t>(
+                               slot.seq.load(std::memory_order_acquire) - pos) < 0) {
+                    overwritten_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                pos = tail_.load(std::memory_order_relaxed);
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // called by the consumer and by producers making room in a full ring
+    bool pop_ring(MessageBasePtr &msg) {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots_[pos % num_slots_];
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    msg = std::move(slot.msg);
+                    slot.seq.store(pos + num_slots_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty, or the oldest message isn't written yet
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push_blocks(MessageBasePtr msg) {
+        // The tail is read before the block it is in. The producer that
+        // links in a block stores it before moving the tail into it, so a
+        // ticket that is claimed successfully is always in the block read.
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        Block *block = tail_block_.load(std::memory_order_acquire);
+        while (true) {
+            const uint64_t offset = tail % lap;
+            if (offset == block_cap) {
+                std::this_thread::yield();
+                tail = tail_.load(std::memory_order_acquire);
+                block = tail_block_.load(std::memory_order_acquire);
+                continue;
+            }
+
+            if (tail_.compare_exchange_weak(tail, tail + 1,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+                if (offset + 1 == block_cap) {
+                    Block *next = take_block();
+                    tail_block_.store(next, std::memory_order_release);
+                    tail_.store(tail + 2, std::memory_order_release);
+                    block->next.store(next, std::memory_order_release);
+                }
+                BlockSlot &slot = block->slots[offset];
+                slot.msg = std::move(msg);
+                slot.written.store(true, std::memory_order_release);
+                return;
+            }
+            block = tail_block_.load(std::memory_order_acquire);
+        }
+    }
+
+    bool pop_blocks(MessageBasePtr &msg) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head % lap == block_cap) {
+            // The block's last slot was read, so its producer, which links
+            // in the next block before writing that slot, is done with it
+            Block *next = head_block_->next.load(std::memory_order_acquire);
+            if (next == nullptr) return false;
+            recycle(head_block_);
+            head_block_ = next;
+            head_.store(++head, std::memory_order_release);
+        }
+
+        BlockSlot &slot = head_block_->slots[head % lap];
+        if (!slot.written.load(std::memory_order_acquire)) {
+            return false; // empty, or the oldest message isn't written yet
+        }
+        msg = std::move(slot.msg);
+        slot.written.store(false, std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only the producer linking in the next block takes a free one, so the
+    // free list is popped by one thread at a time and isn't subject to ABA
+    Block *take_block() {
+        Block *block = free_blocks_.load(std::memory_order_acquire);
+        while (block != nullptr &&
+               !free_blocks_.compare_exchange_weak(
+                   block, block->next.load(std::memory_order_relaxed),
+                   std::memory_order_acquire, std::memory_order_acquire)) {}
+        if (block == nullptr) return new Block();
+        block->next.store(nullptr, std::memory_order_relaxed);
+        return block;
+    }
+
+    void recycle(Block *block) {
+        Block *top = free_blocks_.load(std::memory_order_relaxed);
+        do {
+            block->next.store(top, std::memory_order_relaxed);
+        } while (!free_blocks_.compare_exchange_weak(top, block,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed));
+    }
+
+    static void delete_blocks(Block *block) {
+        while (block != nullptr) {
+            Block *next = block->next.load(std::memory_order_relaxed);
+            delete block;
+            block = next;
+        }
+    }
+
+    // the number of tickets claimed and not yet drained
+    size_t claimed() const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        if (capacity_ > 0) {
+            return tail > head ? static_cast<size_t>(tail - head) : 0;
+        }
+        const uint64_t tail_count = count(tail);
+        const uint64_t head_count = count(head);
+        return tail_count > head_count ? static_cast<size_t>(tail_count - head_count) : 0;
+    }
+
+    static uint64_t count(uint64_t ticket) {
+        const uint64_t offset = ticket % lap;
+        return ticket / lap * block_cap + (offset < block_cap ? offset : block_cap);
+    }
+
+    /*! \brief start the tickets over once the queue is drained, keeping
+     * the tail block. Not safe to call while other threads use the queue.
+     */
+    void reset() {
+        Block *tail_block = tail_block_.load(std::memory_order_relaxed);
+        while (head_block_ != tail_block) {
+            Block *next = head_block_->next.load(std::memory_order_relaxed);
+            recycle(head_block_);
+            head_block_ = next;
+        }
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        overwritten_.store(0, std::memory_order_relaxed);
+    }
+
+    /*! \brief call func on each queued message, oldest first. Not safe to
+     * call while other threads use the queue.
+     */
+    template <class Func>
+    void for_each(Func &&func) const {
+        uint64_t pos = head_.load(std::memory_order_acquire);
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        if (capacity_ > 0) {
+            for (; pos < tail; pos++) {
+                const Slot &slot = slots_[pos % num_slots_];
+                if (slot.seq.load(std::memory_order_acquire) == pos + 1) {
+                    func(slot.msg);
+                }
+            }
+            return;
+        }
+
+        const Block *block = head_block_;
+        for (; pos < tail && block != nullptr; pos++) {
+            const uint64_t offset = pos % lap;
+            if (offset == block_cap) {
+                block = block->next.load(std::memory_order_acquire);
+            } else if (block->slots[offset].written.load(std::memory_order_acquire)) {
+                func(block->slots[offset].msg);
+            }
+        }
+    }
+
+    size_t capacity_ = 0;
+
+    // bounded: a ring of num_slots_ slots
+    size_t num_slots_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Tickets [head_, tail_) have been claimed by producers and not yet
+    // drained. Producers only move head_ to drop a full ring's oldest message.
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> overwritten_{0};
+
+    // unbounded: head_block_ is only used by the consumer
+    Block *head_block_;
+    std::atomic<Block*> tail_block_;
+    std::atomic<Block*> free_blocks_{nullptr};
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_PUBSUB_ATOMICMESSAGEQUEUE_H_
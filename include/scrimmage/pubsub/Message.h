@@ -34,17 +34,39 @@
 #define INCLUDE_SCRIMMAGE_PUBSUB_MESSAGE_H_
 
 #include <scrimmage/pubsub/MessageBase.h>
+
+#include <google/protobuf/message_lite.h>
+
 #include <string>
+#include <type_traits>
 
 namespace scrimmage {
 
+namespace detail {
+template <class T>
+size_t data_size_bytes(const T &data, std::true_type /*is_protobuf*/) {
+    return data.ByteSizeLong();
+}
+
+template <class T>
+size_t data_size_bytes(const T &/*data*/, std::false_type /*is_protobuf*/) {
+    return 0;
+}
+} // namespace detail
+
 template <class T>
 class Message : public MessageBase {
  public:
-    Message() : MessageBase() {}
+    Message() : MessageBase() { type = &typeid(Message<T>); }
     explicit Message(T _data, const std::string &_serialized_data = "") :
-      MessageBase(), data(_data) {}
+      MessageBase(), data(_data) { type = &typeid(Message<T>); }
     T data;
+
+    size_t size_bytes() const override {
+        if (!serialized_data.empty()) return serialized_data.size();
+        return detail::data_size_bytes(
+            data, std::is_base_of<google::protobuf::MessageLite, T>());
+    }
 };
 
 template<class T>
@@ -33,8 +33,10 @@
 #ifndef INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEBASE_H_
 #define INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEBASE_H_
 
+#include <cstddef>
 #include <string>
 #include <memory>
+#include <typeinfo>
 
 namespace scrimmage {
 
@@ -43,13 +45,53 @@ class MessageBase {
     virtual ~MessageBase() {}       // http://stackoverflow.com/a/5831797
 
     static const int undefined_id = -1;
-    double time;
+    double time = 0;
     std::string serialized_data;
 
     std::string debug_info = "";
+
+    /*! \brief Estimate of the message's size on the wire in bytes: the size
+     * of its serialized data or, for a protobuf Message<T>, its encoded
+     * size. Returns 0 when the size isn't known.
+     */
+    virtual size_t size_bytes() const { return serialized_data.size(); }
+
+    /*! \brief size_bytes() when the message was published, if its publisher
+     * collects stats, else 0. Devices sum this instead of sizing each
+     * message again on every pop.
+     */
+    size_t published_size = 0;
+
+    // The type that tagged the message, Message<T> tags itself as
+    // typeid(Message<T>). Untagged messages are cast dynamically.
+    const std::type_info *type = nullptr;
 };
 
 using MessageBasePtr = std::shared_ptr<MessageBase>;
 
+/*! \brief Cast msg to T, returning nullptr if it isn't a T.
+ *
+ * Messages tagged with T are cast statically. known_type caches the tag that
+ * was last found to be T, since plugins loaded from different libraries can
+ * have distinct (but equal) type_info objects for the same type. Other
+ * messages, and all messages when built with CHECKED_MSG_CASTS, are cast
+ * with dynamic_pointer_cast.
+ */
+template <class T>
+std::shared_ptr<T> msg_cast(const MessageBasePtr &msg,
+                            const std::type_info *&known_type) {
+#if !defined(CHECKED_MSG_CASTS) || !CHECKED_MSG_CASTS
+    if (msg->type != nullptr) {
+        if (msg->type == known_type) {
+            return std::static_pointer_cast<T>(msg);
+        } else if (*msg->type == typeid(T)) {
+            known_type = msg->type;
+            return std::static_pointer_cast<T>(msg);
+        }
+    }
+#endif
+    return std::dynamic_pointer_cast<T>(msg);
+}
+
 } // namespace scrimmage
 #endif // INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEBASE_H_
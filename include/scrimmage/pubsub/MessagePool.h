@@ -0,0 +1,102 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEPOOL_H_
+#define INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEPOOL_H_
+
+#include <scrimmage/pubsub/Message.h>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace scrimmage {
+
+/*! \brief Recycles the memory of short-lived messages.
+ *
+ * Blocks are kept on per-thread free lists by size class. A message freed
+ * when its last subscriber drops it returns its block to the freeing
+ * thread's list, ready for the next message of that size. In steady state,
+ * publishing doesn't call the system allocator. Blocks larger than
+ * max_block_size are allocated normally.
+ */
+class MessagePool {
+ public:
+    static constexpr size_t size_class_bytes = 64; // block size step
+    static constexpr size_t max_block_size = 2048;
+    static constexpr size_t max_free_blocks = 1024; // per size class and thread
+
+    static void *allocate(size_t bytes);
+    static void deallocate(void *p, size_t bytes);
+};
+
+/*! \brief std allocator backed by the MessagePool, for std::allocate_shared */
+template <class T>
+class MessagePoolAllocator {
+ public:
+    using value_type = T;
+
+    MessagePoolAllocator() = default;
+    template <class U>
+    MessagePoolAllocator(const MessagePoolAllocator<U> &/*other*/) {} // NOLINT
+
+    T *allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "MessagePool blocks are only aligned for standard types");
+        return static_cast<T*>(MessagePool::allocate(n * sizeof(T)));
+    }
+    void deallocate(T *p, size_t n) {
+        MessagePool::deallocate(p, n * sizeof(T));
+    }
+};
+
+template <class T, class U>
+bool operator==(const MessagePoolAllocator<T> &, const MessagePoolAllocator<U> &) {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const MessagePoolAllocator<T> &, const MessagePoolAllocator<U> &) {
+    return false;
+}
+
+/*! \brief Create a message, like std::make_shared<Message<T>>. Its memory
+ * is recycled by the MessagePool once nothing holds it.
+ */
+template <class T, class... Args>
+std::shared_ptr<Message<T>> make_msg(Args &&... args) {
+    return std::allocate_shared<Message<T>>(
+        MessagePoolAllocator<Message<T>>(), std::forward<Args>(args)...);
+}
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEPOOL_H_
@@ -0,0 +1,106 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEQUEUE_H_
+#define INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEQUEUE_H_
+
+#include <scrimmage/pubsub/MessageBase.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace scrimmage {
+
+/*! \brief FIFO of messages stored in a ring buffer.
+ *
+ * The buffer grows by doubling and never shrinks, so once a queue has seen
+ * its largest burst, pushing and popping messages doesn't allocate.
+ */
+class MessageQueue {
+ public:
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void push_back(MessageBasePtr msg) {
+        if (size_ == buffer_.size()) grow();
+        buffer_[(head_ + size_) & (buffer_.size() - 1)] = std::move(msg);
+        size_++;
+    }
+
+    MessageBasePtr &front() { return buffer_[head_]; }
+
+    void pop_front() {
+        buffer_[head_].reset();
+        head_ = (head_ + 1) & (buffer_.size() - 1);
+        size_--;
+    }
+
+    /*! \brief remove the n oldest messages */
+    void drop_front(size_t n) {
+        for (size_t i = 0; i < n && size_ > 0; i++) pop_front();
+    }
+
+    /*! \brief the i-th oldest message */
+    MessageBasePtr &operator[](size_t i) {
+        return buffer_[(head_ + i) & (buffer_.size() - 1)];
+    }
+
+    void clear() {
+        while (size_ > 0) pop_front();
+        head_ = 0;
+    }
+
+    /*! \brief exchange contents with another queue without copying */
+    void swap(MessageQueue &other) {
+        buffer_.swap(other.buffer_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+ protected:
+    void grow() {
+        std::vector<MessageBasePtr> buffer(buffer_.empty() ? 8 : 2 * buffer_.size());
+        for (size_t i = 0; i < size_; i++) {
+            buffer[i] = std::move((*this)[i]);
+        }
+        buffer_.swap(buffer);
+        head_ = 0;
+    }
+
+    std::vector<MessageBasePtr> buffer_; // size is zero or a power of two
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_PUBSUB_MESSAGEQUEUE_H_
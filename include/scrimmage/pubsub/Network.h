@@ -36,6 +36,7 @@
 #include <scrimmage/fwd_decl.h>
 #include <scrimmage/plugin_manager/Plugin.h>
 #include <scrimmage/common/CSV.h>
+#include <scrimmage/pubsub/MessageQueue.h>
 
 #include <map>
 #include <list>
@@ -66,6 +67,12 @@ class Network : public Plugin {
     inline virtual void set_mission_parse(MissionParsePtr mp)
     { mp_ = mp; }
 
+    /*! \brief Messages published and received this step on each monitored
+     * topic, keyed by topic ("*" for all topics)
+     */
+    const std::map<std::string, unsigned int> &pub_counts() const { return pub_counts_; }
+    const std::map<std::string, unsigned int> &sub_counts() const { return sub_counts_; }
+
  protected:
     RTreePtr rtree_;
     RandomPtr random_;
@@ -82,15 +89,51 @@ class Network : public Plugin {
     virtual bool is_successful_transmission(const scrimmage::PluginPtr &pub_plugin,
                                             const scrimmage::PluginPtr &sub_plugin);
 
+    /*! \brief Called with the messages popped from a publisher, before they
+     * are transmitted to its subscribers.
+     */
+    virtual void published(const NetworkDevicePtr &pub, MessageQueue &msgs) {}
+
+    /*! \brief Hand the index-th message published by pub to sub, returning
+     * false if it was dropped. By default the message is delivered
+     * immediately. Networks that hold messages back call delivered() when
+     * they hand them to the subscriber.
+     */
+    virtual bool transmit(const NetworkDevicePtr &pub, const NetworkDevicePtr &sub,
+                          const MessageBasePtr &msg, size_t index);
+
+    /*! \brief Called after all publishers have been routed, before this
+     * step's counts are written.
+     */
+    virtual void routed() {}
+
+    /*! \brief Count a message received by sub on this step. */
+    void delivered(const NetworkDevicePtr &sub);
+
     bool network_init(std::map<std::string, std::string> &/*mission_params*/,
                       std::map<std::string, std::string> &/*plugin_params*/);
 
  private:
+    template <class Devices>
+    void deliver(NetworkDevicePtr &pub, Devices &subs, unsigned int *pub_count);
+
+    unsigned int *count(std::map<std::string, unsigned int> &counts,
+                        const std::string &topic);
+
     // Key: Topic String
     std::map<std::string, unsigned int> pub_counts_;
     std::map<std::string, unsigned int> sub_counts_;
     bool monitor_all_pubs_ = false;
     bool monitor_all_subs_ = false;
+    unsigned int *all_pub_count_ = nullptr;
+    unsigned int *all_sub_count_ = nullptr;
+
+    // Monitored counts indexed by topic id (nullptr if not monitored)
+    std::vector<unsigned int*> topic_pub_counts_;
+    std::vector<unsigned int*> topic_sub_counts_;
+
+    // Messages popped from the publisher currently being routed
+    MessageQueue msgs_;
 
     // Logging utility
     bool write_csv_ = false;
@@ -35,12 +35,14 @@
 
 #include <scrimmage/pubsub/MessageBase.h>
 #include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessageQueue.h>
+#include <scrimmage/pubsub/AtomicMessageQueue.h>
+#include <scrimmage/pubsub/PubSubStats.h>
 
 #include <type_traits>
 #include <list>
 #include <memory>
 #include <string>
-#include <mutex> // NOLINT
 
 namespace scrimmage {
 
@@ -61,11 +63,19 @@ class NetworkDevice {
     std::string get_topic() const;
     void set_topic(const std::string &topic);
 
+    /*! \brief the id PubSub interned the topic as, within its network */
+    int topic_id() const { return topic_id_; }
+    void set_topic_id(int id) { topic_id_ = id; }
+
     void set_msg_list(const std::list<MessageBasePtr> &msg_list);
     void clear_msg_list();
 
     unsigned int msg_list_size() {
-        return msg_list_.size();
+        return msg_queue_.size();
+    }
+
+    bool has_msgs() const {
+        return !msg_queue_.empty();
     }
 
     void set_max_queue_size(unsigned int size);
@@ -73,22 +83,42 @@ class NetworkDevice {
     void enable_queue_size(bool enforce);
     bool enable_queue_size();
 
+    /*! \brief Drop the oldest messages beyond max_queue_size. A bounded
+     * queue overwrites its oldest message as new ones arrive, so this only
+     * has work to do when max_queue_size is 0.
+     */
     void enforce_queue_size();
 
+    /*! \brief add a message to the queue, safe to call from any thread */
     void add_msg(MessageBasePtr msg);
 
+    /*! \brief Move the queued messages into msgs, which is cleared first.
+     * Only one thread may pop a device's messages at a time.
+     */
+    void pop_msgs(MessageQueue &msgs);
+
+    /*! \brief Traffic through the device, only written by the thread that
+     * pops its messages.
+     */
+    NetworkDeviceStats &stats() { return stats_; }
+    const NetworkDeviceStats &stats() const { return stats_; }
+
+    /*! \brief Whether the bytes of published and popped messages are
+     * counted. Sizing a protobuf walks the whole message, so it is only done
+     * when the stats are written out.
+     */
+    void collect_stats(bool collect) { collect_stats_ = collect; }
+    bool collect_stats() const { return collect_stats_; }
+
     template <class T = MessageBase,
               class = std::enable_if_t<std::is_same<T, MessageBase>::value, void>>
     std::list<MessageBasePtr> pop_msgs() {
-        mutex_.lock();
+        MessageQueue msgs;
+        pop_msgs(msgs);
         std::list<MessageBasePtr> msg_list_cast;
-
-        auto it = msg_list_.begin();
-        while (it != msg_list_.end()) {
-            msg_list_cast.push_back(*it);
-            it = msg_list_.erase(it);
+        for (size_t i = 0; i < msgs.size(); i++) {
+            msg_list_cast.push_back(std::move(msgs[i]));
         }
-        mutex_.unlock();
         return msg_list_cast;
     }
 
@@ -96,21 +126,19 @@ class NetworkDevice {
               class = std::enable_if_t<!std::is_same<T, MessageBase>::value &&
                                        std::is_base_of<MessageBase, T>::value, void>>
     std::list<std::shared_ptr<T>> pop_msgs() {
-        mutex_.lock();
+        MessageQueue msgs;
+        pop_msgs(msgs);
         std::list<std::shared_ptr<T>> msg_list_cast;
-
-        auto it = msg_list_.begin();
-        while (it != msg_list_.end()) {
-            auto msg_cast = std::dynamic_pointer_cast<T>(*it);
+        const std::type_info *type = &typeid(T);
+        for (size_t i = 0; i < msgs.size(); i++) {
+            auto msg_cast = scrimmage::msg_cast<T>(msgs[i], type);
             if (msg_cast) {
                 msg_list_cast.push_back(msg_cast);
-                } else {
+            } else {
                 print_str(std::string("WARNING: could not cast message on topic \"")
                           + topic_);
             }
-            it = msg_list_.erase(it);
         }
-        mutex_.unlock();
         return msg_list_cast;
     }
 
@@ -163,12 +191,17 @@ class NetworkDevice {
 
  protected:
     std::string topic_ = "";
+    int topic_id_ = -1;
+    // Subscribers tell their plugin when they are sent a message
+    bool notify_plugin_ = false;
     unsigned int max_queue_size_ = 1;
     bool enable_queue_size_ = false;
+    bool collect_stats_ = false;
     PluginPtr plugin_;
     void print_str(const std::string &msg);
-    std::list<MessageBasePtr> msg_list_;
-    std::mutex mutex_;
+    void update_queue_capacity();
+    AtomicMessageQueue msg_queue_;
+    NetworkDeviceStats stats_;
 };
 using NetworkDevicePtr = std::shared_ptr<NetworkDevice>;
 } // namespace scrimmage
@@ -34,10 +34,13 @@
 #define INCLUDE_SCRIMMAGE_PUBSUB_PUBSUB_H_
 
 #include <scrimmage/pubsub/Subscriber.h>
+#include <scrimmage/pubsub/PubSubStats.h>
 
 #include <map>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace boost {
 template <class T> class optional;
@@ -63,6 +66,44 @@ class PubSub {
     TopicMap &pubs() { return pub_map_; }
     TopicMap &subs() { return sub_map_; }
 
+    /*! \brief the publishers and subscribers of one topic on a network */
+    struct TopicRoute {
+        std::string topic;
+        std::vector<NetworkDevicePtr> pubs;
+        std::vector<NetworkDevicePtr> subs;
+    };
+
+    /*! \brief The topics of a network, indexed by the id each topic was
+     * interned as when it was first advertised or subscribed to. This holds
+     * the same devices as pubs() and subs(), but resolved ahead of time so
+     * that routing messages doesn't look up topic names.
+     */
+    struct NetworkRoutes {
+        std::vector<TopicRoute> topics;
+        std::vector<int> order; // topic ids sorted by topic name
+        std::unordered_map<std::string, int> ids;
+    };
+
+    /*! \brief the id of topic on the network, interning it if it is new */
+    int topic_id(const std::string &network_name, const std::string &topic);
+
+    /*! \brief the routes of a network or nullptr if it has no devices */
+    NetworkRoutes *routes(const std::string &network_name);
+
+    /*! \brief The traffic of each topic, summed over its publishers and
+     * subscribers, ordered by network and topic name. Only call this
+     * between steps, when no thread is popping messages.
+     */
+    std::vector<TopicStats> topic_stats();
+
+    /*! \brief Count the bytes of messages for topic_stats(), for the
+     * current devices and those added later. Off by default.
+     */
+    void collect_stats(bool collect);
+
+    /*! \brief remove all publishers and subscribers */
+    void clear();
+
     void add_network_name(const std::string &str);
 
     boost::optional<std::list<NetworkDevicePtr>> find_devices(const std::string &network_name,
@@ -90,6 +131,7 @@ class PubSub {
             std::make_shared<Subscriber<T, CallbackFunc>>(
                 topic, max_queue_size, enable_queue_size, plugin, callback);
         sub_map_[network_name][topic].push_back(sub);
+        add_route(network_name, sub, false);
         return sub;
     }
 
@@ -100,6 +142,9 @@ class PubSub {
  protected:
     TopicMap pub_map_;
     TopicMap sub_map_;
+    std::map<std::string, NetworkRoutes> routes_;
+    bool collect_stats_ = false;
+    void add_route(const std::string &network_name, NetworkDevicePtr dev, bool pub);
     void print_str(const std::string &s);
 };
 using PubSubPtr = std::shared_ptr<PubSub>;
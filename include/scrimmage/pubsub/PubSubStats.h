@@ -0,0 +1,138 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#ifndef INCLUDE_SCRIMMAGE_PUBSUB_PUBSUBSTATS_H_
+#define INCLUDE_SCRIMMAGE_PUBSUB_PUBSUBSTATS_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace scrimmage {
+
+/*! \brief Counts values in power of two buckets. Bucket 0 holds zeros and
+ * bucket i holds values in [2^(i-1), 2^i), with the last bucket also
+ * holding everything larger.
+ */
+class Log2Histogram {
+ public:
+    static constexpr int num_buckets = 32;
+
+    void add(uint64_t value) { counts_[bucket(value)]++; }
+
+    void merge(const Log2Histogram &other) {
+        for (int i = 0; i < num_buckets; i++) counts_[i] += other.counts_[i];
+    }
+
+    uint64_t count() const {
+        uint64_t count = 0;
+        for (uint64_t c : counts_) count += c;
+        return count;
+    }
+
+    /*! \brief upper bound of the bucket holding the q-th quantile (0 to 1) */
+    uint64_t quantile(double q) const {
+        uint64_t total = count();
+        uint64_t seen = 0;
+        for (int i = 0; i < num_buckets; i++) {
+            seen += counts_[i];
+            if (seen > 0 && seen >= q * total) return i == 0 ? 0 : (uint64_t(1) << i);
+        }
+        return 0;
+    }
+
+    const std::array<uint64_t, num_buckets> &counts() const { return counts_; }
+
+    static int bucket(uint64_t value) {
+        int bits = value == 0 ? 0 : 64 - __builtin_clzll(value);
+        return bits < num_buckets ? bits : num_buckets - 1;
+    }
+
+ protected:
+    std::array<uint64_t, num_buckets> counts_{};
+};
+
+/*! \brief Traffic through one publisher or subscriber.
+ *
+ * Each device's stats are only written by the thread that pops its queue:
+ * the network for publishers and the owning entity's thread for
+ * subscribers. Recording them needs no atomics or locks.
+ */
+struct NetworkDeviceStats {
+    uint64_t msgs = 0;            // messages popped from the queue
+    uint64_t bytes = 0;           // MessageBase::size_bytes() of the popped messages
+    uint64_t dropped = 0;         // messages dropped by the max queue size
+    uint64_t max_queue_depth = 0;
+    Log2Histogram queue_depth;    // messages queued when popped
+
+    // subscribers only
+    uint64_t callback_ns = 0;
+    Log2Histogram callback_time_ns; // per pop of the subscriber's messages
+    double latency_sum = 0;         // sim seconds from being sent to handled
+    Log2Histogram latency_us;
+
+    void add_pop(uint64_t num_msgs, uint64_t num_bytes, uint64_t num_dropped) {
+        msgs += num_msgs;
+        bytes += num_bytes;
+        dropped += num_dropped;
+        uint64_t depth = num_msgs + num_dropped;
+        if (depth > max_queue_depth) max_queue_depth = depth;
+        queue_depth.add(depth);
+    }
+
+    void merge(const NetworkDeviceStats &other) {
+        msgs += other.msgs;
+        bytes += other.bytes;
+        dropped += other.dropped;
+        if (other.max_queue_depth > max_queue_depth) {
+            max_queue_depth = other.max_queue_depth;
+        }
+        queue_depth.merge(other.queue_depth);
+        callback_ns += other.callback_ns;
+        callback_time_ns.merge(other.callback_time_ns);
+        latency_sum += other.latency_sum;
+        latency_us.merge(other.latency_us);
+    }
+};
+
+/*! \brief The traffic of all publishers and subscribers of a topic */
+struct TopicStats {
+    std::string network;
+    std::string topic;
+    unsigned int num_pubs = 0;
+    unsigned int num_subs = 0;
+    NetworkDeviceStats pubs;
+    NetworkDeviceStats subs;
+};
+
+} // namespace scrimmage
+#endif // INCLUDE_SCRIMMAGE_PUBSUB_PUBSUBSTATS_H_
@@ -34,9 +34,13 @@
 #define INCLUDE_SCRIMMAGE_PUBSUB_PUBLISHER_H_
 
 #include <scrimmage/pubsub/NetworkDevice.h>
+#include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessagePool.h>
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include <boost/type_index.hpp>
 
@@ -55,8 +59,20 @@ class Publisher : public NetworkDevice {
         if (add_debug_info) {
             set_debug_info(msg, boost::typeindex::type_id<T>().pretty_name());
         }
+        // sized once here rather than by every device that pops it
+        if (collect_stats_) {
+            msg->published_size = msg->size_bytes();
+        }
         add_msg(msg);
     }
+
+    /*! \brief Create a message to publish, like std::make_shared. Its
+     * memory is recycled by the MessagePool once no subscriber holds it.
+     */
+    template <class T, class... Args>
+    std::shared_ptr<Message<T>> make_msg(Args &&... args) {
+        return scrimmage::make_msg<T>(std::forward<Args>(args)...);
+    }
     std::function<void(MessageBasePtr)> callback;
 
  protected:
@@ -48,11 +48,11 @@ class Subscriber : public SubscriberBase {
                bool enable_queue_size, PluginPtr plugin,
                CallbackFunc callback)
         : SubscriberBase(topic, max_queue_size, enable_queue_size, plugin),
-        callback_(callback) {
+        callback_(callback), type_(&typeid(scrimmage::Message<T>)) {
     }
 
     void accept(scrimmage::MessageBasePtr msg) override {
-        auto msg_cast = std::dynamic_pointer_cast<scrimmage::Message<T>>(msg);
+        auto msg_cast = scrimmage::msg_cast<scrimmage::Message<T>>(msg, type_);
         if (msg_cast != nullptr) {
             callback_(msg_cast);
         } else {
@@ -62,6 +62,9 @@ class Subscriber : public SubscriberBase {
 
  protected:
     CallbackFunc callback_;
+
+    // The message type this subscriber accepts, resolved when subscribing
+    const std::type_info *type_;
 };
 } // namespace scrimmage
 #endif // INCLUDE_SCRIMMAGE_PUBSUB_SUBSCRIBER_H_
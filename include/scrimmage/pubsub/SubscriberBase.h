@@ -42,7 +42,9 @@ class SubscriberBase : public NetworkDevice {
     SubscriberBase() = default;
     SubscriberBase(const std::string &topic, unsigned int &max_queue_size,
                    bool enable_queue_size, PluginPtr plugin) :
-        NetworkDevice(topic, max_queue_size, enable_queue_size, plugin) {}
+        NetworkDevice(topic, max_queue_size, enable_queue_size, plugin) {
+        notify_plugin_ = true;
+    }
     virtual void accept(scrimmage::MessageBasePtr msg) = 0;
 
  protected:
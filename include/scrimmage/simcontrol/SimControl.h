@@ -39,16 +39,19 @@
 
 #include <scrimmage/common/Timer.h>
 #include <scrimmage/common/DelayedTask.h>
+#include <scrimmage/common/TaskScheduler.h>
 #include <scrimmage/common/FileSearch.h>
+#include <scrimmage/log/FrameLogger.h>
+#include <scrimmage/log/FrameLogPolicy.h>
 #include <scrimmage/proto/Shape.pb.h>
 #include <scrimmage/proto/Visual.pb.h>
 
-#include <future> // NOLINT
+#include <functional>
 #include <memory>
-#include <deque>
 #include <vector>
 #include <set>
 #include <string>
+#include <utility>
 #include <thread> // NOLINT
 #include <map>
 #include <list>
@@ -77,7 +80,10 @@ class SimControl {
     bool finished();
     void set_finished(bool finished);
 
-    void get_contacts(std::unordered_map<int, Contact> &contacts);
+    /*! \brief copy of the contacts whose states don't change as the
+     * simulation runs
+     */
+    void get_contacts(ContactMap &contacts);
     void set_contacts(ContactMapPtr &contacts);
 
     void get_contact_visuals(std::map<int, ContactVisualPtr> &contact_visuals);
@@ -96,6 +102,9 @@ class SimControl {
 
     bool output_summary();
     bool output_runtime();
+    bool output_pubsub_stats();
+    /*! \brief count message bytes for output_pubsub_stats() */
+    void collect_pubsub_stats(bool collect);
     void setup_timer(double rate, double time_warp);
     void start_overall_timer();
     void start_loop_timer();
@@ -119,10 +128,10 @@ class SimControl {
     PluginManagerPtr &plugin_manager();
     FileSearchPtr &file_search();
 
-    struct Task {
-        EntityPtr ent;
-        std::promise<bool> prom;
-    };
+    using EntityTaskFunc =
+        std::function<bool(EntityPtr &, std::list<ShapePtr> &)>;
+
+    TaskScheduler &scheduler();
 
     bool take_step();
 
@@ -154,7 +163,8 @@ class SimControl {
 
     ContactMapPtr contacts_;
 
-    std::map<int, std::list<scrimmage_proto::ShapePtr>> shapes_;
+    // shapes drawn by networks and entity interactions
+    std::list<scrimmage_proto::ShapePtr> shapes_;
 
     std::map<int, ContactVisualPtr> contact_visuals_;
 
@@ -188,21 +198,37 @@ class SimControl {
     std::mutex take_step_mutex_;
     std::mutex time_mutex_;
     std::mutex time_warp_mutex_;
-    std::mutex entity_pool_mutex_;
 
     bool use_entity_threads_ = false;
+    bool parallel_motion_ = false;
     int num_entity_threads_ = 0;
-    bool entity_pool_stop_ = false;
-    std::deque<std::shared_ptr<Task>> entity_pool_queue_;
-    std::condition_variable_any entity_pool_condition_var_;
-    std::vector<std::thread> entity_worker_threads_;
-    void worker();
+    TaskScheduler scheduler_;
+
+    // Random access copy of ents_ for the parallel phases and the shapes
+    // drawn by each entity's controller and motion model (same index as
+    // ent_vec_)
+    std::vector<EntityPtr> ent_vec_;
+    std::vector<std::list<ShapePtr>> ent_shapes_;
+
+    // entity shapes collected by each scheduler thread, tagged with the
+    // index of the entity that drew them
+    std::vector<std::vector<std::pair<size_t, ShapePtr>>> thread_shapes_;
+
     bool run_entities();
-    bool run_motion(EntityPtr &ent, double t, double dt);
+    bool run_entity_tasks(const std::string &phase, EntityTaskFunc func);
+    bool run_post_motion(size_t begin, size_t end, int thread_id);
+    bool run_motion(EntityPtr &ent, double t, double dt,
+                    std::list<ShapePtr> &shapes);
     bool reset_autonomies();
 
     std::shared_ptr<Log> log_;
 
+    // sends frames from a background thread when async_logging is set
+    FrameLogger frame_logger_;
+
+    // decides which frames are logged when frame_logging is set
+    FrameLogPolicy frame_log_policy_;
+
     std::set<EndConditionFlags> end_conditions_ = {EndConditionFlags::NONE};
 
     RandomPtr random_;
@@ -221,6 +247,11 @@ class SimControl {
     int next_id_ = 1;
     FileSearchPtr file_search_;
     RTreePtr rtree_;
+    StateStorePtr state_store_;
+    bool incremental_rtree_ = false;
+    double rtree_time_ = 0;
+    bool neighbor_lists_ = false;
+    double neighbor_lists_time_ = 0;
 
     void request_screenshot();
     void create_rtree();
@@ -228,7 +259,9 @@ class SimControl {
     void set_autonomy_contacts();
     void run_dynamics();
     bool run_interaction_detection();
-    bool run_logging();
+    bool run_logging(bool last_frame = false);
+    /*! \brief write a frame to the log without displaying it */
+    void save_frame(FrameSnapshot &snapshot);
     bool run_metrics();
     void run_remove_inactive();
     void run_check_network_msgs();
@@ -66,7 +66,7 @@ bool create_ent_inters(const SimUtilsInfo &info,
 
 bool create_metrics(const SimUtilsInfo &info, std::list<MetricsPtr> &metrics_list);
 
-void run_callbacks(PluginPtr plugin);
+void run_callbacks(const PluginPtr &plugin);
 
 void print_io_error(const std::string &in_name, VariableIO &v);
 
@@ -38,7 +38,10 @@
 #include <scrimmage/math/Quaternion.h>
 #include <scrimmage/math/State.h>
 #include <scrimmage/entity/Contact.h>
+#include <scrimmage/log/FrameReader.h>
 #include <scrimmage/log/Log.h>
+#include <scrimmage/proto/Frame.pb.h>
+#include <scrimmage/proto/ProtoConversions.h>
 #include <py_utils.h>
 
 #include <string>
@@ -56,35 +59,30 @@ private:
 
 pybind11::object frames2pandas(std::string &fname) {
 
-    // TODO: not sure if this is working after log refactor
-    scrimmage::Log log;
-    if (!log.parse(fname, scrimmage::Log::FRAMES)) {
+    // The frames are read one at a time, so only the rows are kept in memory
+    scrimmage::FrameReader reader;
+    if (!reader.open(fname)) {
         throw MyException((fname + "does not exist").c_str());
     }
 
     pybind11::list data;
-    for (scrimmage::Frame &frame : log.scrimmage_frames()) {
-        for (auto &kv : *(frame.contacts_)) {
-            unsigned int id = kv.first;
-            scrimmage::Contact &c = kv.second;
-
-            Eigen::Vector3d &p = c.state()->pos();
-            Eigen::Vector3d &v = c.state()->vel();
-            scrimmage::Quaternion &q = c.state()->quat();
+    for (const scrimmage_proto::Frame &frame : reader) {
+        for (const scrimmage_proto::Contact &c : frame.contact()) {
+            const scrimmage_proto::State &s = c.state();
+            scrimmage::Quaternion q = scrimmage::proto_2_quat(s.orientation());
 
             pybind11::list row;
-            row.append(pybind11::float_(frame.time_));
-            row.append(pybind11::int_(id));
+            row.append(pybind11::float_(frame.time()));
+            row.append(pybind11::int_(c.id().id()));
             row.append(pybind11::int_(c.id().team_id()));
             row.append(pybind11::int_(c.id().sub_swarm_id()));
-            int type = static_cast<int>(c.type());
-            row.append(pybind11::int_(type));
-            row.append(pybind11::float_(p(0)));
-            row.append(pybind11::float_(p(1)));
-            row.append(pybind11::float_(p(2)));
-            row.append(pybind11::float_(v(0)));
-            row.append(pybind11::float_(v(1)));
-            row.append(pybind11::float_(v(2)));
+            row.append(pybind11::int_(static_cast<int>(c.type())));
+            row.append(pybind11::float_(s.position().x()));
+            row.append(pybind11::float_(s.position().y()));
+            row.append(pybind11::float_(s.position().z()));
+            row.append(pybind11::float_(s.velocity().x()));
+            row.append(pybind11::float_(s.velocity().y()));
+            row.append(pybind11::float_(s.velocity().z()));
             row.append(pybind11::float_(q.yaw()));
             row.append(pybind11::float_(q.pitch()));
             row.append(pybind11::float_(q.roll()));
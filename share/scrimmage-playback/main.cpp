@@ -37,7 +37,9 @@
 #endif
 
 #include <scrimmage/common/Timer.h>
+#include <scrimmage/log/FrameReader.h>
 #include <scrimmage/log/Log.h>
+#include <scrimmage/proto/Frame.pb.h>
 
 #include <iostream>
 #include <iomanip>
@@ -64,18 +66,27 @@ void HandleSignal(int s) {
     cout << endl << "Exiting gracefully" << endl;
 }
 
+// Get dt from the first two frames
+bool frames_dt(sc::FrameReader &frames, double &dt) {
+    frames.rewind();
+    bool found = false;
+    if (frames.next()) {
+        double t0 = frames.frame().time();
+        if (frames.next()) {
+            dt = frames.frame().time() - t0;
+            found = true;
+        }
+    }
+    frames.rewind();
+    return found;
+}
+
 void playback_loop(std::shared_ptr<sc::Log> log,
+                   std::shared_ptr<sc::FrameReader> frames,
                    sc::InterfacePtr in_interface,
                    sc::InterfacePtr out_interface) {
-    // Get dt from first two frames
     double dt = 0.1;
-    if (log->frames().size() >= 2) {
-        auto it = log->frames().begin();
-        double t0 = (*it)->time();
-        ++it;
-        double t1 = (*it)->time();
-        dt = t1 - t0;
-    } else {
+    if (!frames_dt(*frames, dt)) {
         cout << "Fewer than two frames parsed. Using dt: " << dt << endl;
     }
 
@@ -96,29 +107,32 @@ void playback_loop(std::shared_ptr<sc::Log> log,
     auto it_contact_visual = log->contact_visual().begin();
 
     timer.start_overall_timer();
-    for (auto it = log->frames().begin(); it != log->frames().end(); it++) {
+    // The frames are parsed as they are played back. Each is copied, since
+    // the interface keeps the frames that it sends.
+    for (const sp::Frame &next_frame : *frames) {
+        auto frame = std::make_shared<sp::Frame>(next_frame);
         timer.start_loop_timer();
         // Send all other messages up to current frame time before sending
         // current frame
         while (it_shapes != log->shapes().end() &&
-               (*it_shapes)->time() <= (*it)->time()) {
+               (*it_shapes)->time() <= frame->time()) {
             out_interface->send_shapes(**it_shapes);
             ++it_shapes;
         }
 
         while (it_utm_terrain != log->utm_terrain().end() &&
-               (*it_utm_terrain)->time() <= (*it)->time()) {
+               (*it_utm_terrain)->time() <= frame->time()) {
             out_interface->send_utm_terrain(*it_utm_terrain);
             ++it_utm_terrain;
         }
 
         while (it_contact_visual != log->contact_visual().end() &&
-               (*it_contact_visual)->time() <= (*it)->time()) {
+               (*it_contact_visual)->time() <= frame->time()) {
             out_interface->send_contact_visual(*it_contact_visual);
             ++it_contact_visual;
         }
 
-        out_interface->send_frame(*it);
+        out_interface->send_frame(frame);
 
         // Wait loop timer.
         // Stay in loop if currently paused.
@@ -155,7 +169,7 @@ void playback_loop(std::shared_ptr<sc::Log> log,
             }
 
             scrimmage_proto::SimInfo info;
-            info.set_time((*it)->time());
+            info.set_time(frame->time());
             info.set_desired_warp(timer.time_warp());
             info.set_actual_warp(timer.time_warp());
             out_interface->send_sim_info(info);
@@ -183,9 +197,29 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
-    // Setup Logger
+    // Setup Logger. Only the shapes, terrain and contact visuals are parsed
+    // up front, the frames are read from the file as they are played.
     std::shared_ptr<sc::Log> log(new sc::Log);
-    log->init(std::string(argv[1]), sc::Log::READ);
+    log->init(std::string(argv[1]), sc::Log::NONE);
+    if (fs::exists(log->shapes_filename())) {
+        log->parse(log->shapes_filename(), sc::Log::SHAPES);
+    }
+    if (fs::exists(log->utm_terrain_filename())) {
+        log->parse(log->utm_terrain_filename(), sc::Log::UTMTERRAIN);
+    }
+    if (fs::exists(log->contact_visual_filename())) {
+        log->parse(log->contact_visual_filename(), sc::Log::CONTACTVISUAL);
+    }
+
+    // Runs with compressed_frames save frames.delta instead of frames.bin
+    std::string frames_filename = log->frames_filename();
+    if (!fs::exists(frames_filename) && fs::exists(log->compressed_frames_filename())) {
+        frames_filename = log->compressed_frames_filename();
+    }
+    auto frames = std::make_shared<sc::FrameReader>();
+    if (!frames->open(frames_filename)) {
+        return -1;
+    }
 
     sc::InterfacePtr to_gui_interface(new sc::Interface);
     sc::InterfacePtr from_gui_interface(new sc::Interface);
@@ -201,9 +235,15 @@ int main(int argc, char *argv[]) {
     // std::thread server_thread(&Interface::init_network, &(*incoming_interface_),
     //                           Interface::server, "localhost", 50051);
 
-    cout << "Frames parsed: " << log->frames().size() << endl;
+    size_t num_frames = 0;
+    while (frames->skip()) num_frames++;
+    frames->rewind();
+    cout << "Frames found: " << num_frames << endl;
+
+    double dt = 1.0e-6;
+    frames_dt(*frames, dt);
 
-    std::thread playback(playback_loop, log, from_gui_interface,
+    std::thread playback(playback_loop, log, frames, from_gui_interface,
                          to_gui_interface);
     playback.detach(); // todo
 
@@ -212,14 +252,6 @@ int main(int argc, char *argv[]) {
     viewer.set_incoming_interface(to_gui_interface);
     viewer.set_outgoing_interface(from_gui_interface);
 
-    double dt;
-    if (log->frames().size() >= 2) {
-        auto frame2 = *(std::next(log->frames().begin(), 1));
-        auto frame1 = log->frames().front();
-        dt = frame2->time() - frame1->time();
-    } else {
-        dt = 1.0e-6;
-    }
     viewer.init({}, "", dt);
     viewer.run();
 
@@ -33,6 +33,10 @@
 #include <scrimmage/common/RTree.h>
 #include <boost/geometry.hpp>
 #include <boost/geometry/index/rtree.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+
+#include <algorithm>
+#include <chrono> // NOLINT
 
 namespace bg = boost::geometry;
 namespace bgi = boost::geometry::index;
@@ -43,78 +47,187 @@ void RTree::init(int size) {
     if (size > 0) {
         rtree_ = std::make_shared<rtree_t>(bgi::dynamic_rstar(size));
         size_ = size;
+        if (index_) index_->init(size);
     }
 }
 
 void RTree::clear() {
+    if (index_) index_->clear();
     rtree_->clear();
-    rtree_team_.clear();
+
+    // keep the team trees around so they aren't reallocated when the
+    // entities are added back
+    for (auto &kv : rtree_team_) {
+        kv.second->clear();
+    }
+
+    for (const point_id_t &value : entries_) {
+        entry_index(value.second.id()) = -1;
+    }
+    entries_.clear();
+    lists_valid_ = false;
+    added_.clear();
+    removed_.clear();
+    moved_.clear();
 }
 
-void RTree::add(Eigen::Vector3d &pos, const ID &id) {
-    point p(pos(0), pos(1), pos(2));
-    std::pair<point, ID> pair(p, id);
-    rtree_->insert(pair);
+int &RTree::entry_index(int id) {
+    std::vector<int> &index = id >= 0 ? entry_of_id_ : entry_of_neg_id_;
+    const size_t i = id >= 0 ? id : -(id + 1);
+    if (i >= index.size()) {
+        index.resize(i + 1, -1);
+    }
+    return index[i];
+}
 
-    int team_id = id.team_id();
+rtreePtr &RTree::team_tree(int team_id) {
     auto it = rtree_team_.find(team_id);
     if (it == rtree_team_.end()) {
         rtreePtr rtree = std::make_shared<rtree_t>(bgi::dynamic_rstar(size_));
         it = rtree_team_.insert(std::make_pair(team_id, rtree)).first;
     }
-    it->second->insert(pair);
+    return it->second;
 }
 
-void results_to_neighbors(std::list<point_id_t> &results,
-                          std::vector<ID> &neighbors,
-                          int self_id) {
-    neighbors.clear();
-    neighbors.reserve(results.size());
-    if (self_id >= 0) {
-        for (point_id_t &pt_id : results) {
-            if (pt_id.second.id() != self_id) {
-                neighbors.push_back(pt_id.second);
-            }
-        }
+void RTree::add(Eigen::Vector3d &pos, const ID &id) {
+    point p(pos(0), pos(1), pos(2));
+    std::pair<point, ID> pair(p, id);
+    int &entry = entry_index(id.id());
+    if (entry == -1) {
+        entry = static_cast<int>(entries_.size());
+        entries_.push_back(pair);
+    } else {
+        entries_[entry] = pair;
+    }
+    lists_valid_ = false;
+    if (index_) {
+        index_->add(pos, id);
+        return;
+    }
+    rtree_->insert(pair);
+    team_tree(id.team_id())->insert(pair);
+}
+
+void RTree::update(const Eigen::Vector3d &pos, const ID &id) {
+    point_id_t value(point(pos(0), pos(1), pos(2)), id);
+
+    int &entry = entry_index(id.id());
+    if (entry == -1) {
+        entry = static_cast<int>(entries_.size());
+        entries_.push_back(value);
+        added_.push_back(value);
     } else {
-        for (point_id_t &pt_id : results) {
-            neighbors.push_back(pt_id.second);
+        point_id_t &old = entries_[entry];
+        if (!bg::equals(old.first, value.first) ||
+                old.second.team_id() != id.team_id()) {
+            moved_.emplace_back(old, value);
+            old = value;
         }
     }
 }
 
-void RTree::nearest_n_neighbors(const Eigen::Vector3d &pos,
-                                std::vector<ID> &neighbors, unsigned int n,
-                                int self_id, int team_id) {
-    std::list<point_id_t> results;
-    point sought(pos(0), pos(1), pos(2));
+void RTree::remove(const ID &id) {
+    int &entry = entry_index(id.id());
+    if (entry == -1) return;
 
-    if (self_id != -1) {
-        // assume that if an id is given then it will be located at pos so
-        // would always be in the neighborhood
-        n += 1;
+    // move the last value into the hole to keep entries_ packed
+    const int i = entry;
+    entry = -1;
+    removed_.push_back(entries_[i]);
+    if (i + 1 != static_cast<int>(entries_.size())) {
+        entries_[i] = entries_.back();
+        entry_index(entries_[i].second.id()) = i;
     }
+    entries_.pop_back();
+}
+
+void RTree::commit() {
+    const size_t num_changed = added_.size() + removed_.size() + moved_.size();
+    if (num_changed == 0) return;
+    lists_valid_ = false;
 
-    if (team_id == -1) {
-        rtree_->query(bgi::nearest(sought, n), std::front_inserter(results));
+    auto t0 = std::chrono::steady_clock::now();
+    bool bulk = index_ || num_changed > rebuild_fraction_ * entries_.size();
+    if (bulk) {
+        rebuild();
     } else {
-        auto it = rtree_team_.find(team_id);
-        if (it == rtree_team_.end()) {
-            neighbors.clear();
-            return;
-        } else {
-            it->second->query(bgi::nearest(sought, n), std::front_inserter(results));
+        for (point_id_t &value : removed_) {
+            rtree_->remove(value);
+            team_tree(value.second.team_id())->remove(value);
+        }
+        for (auto &old_new : moved_) {
+            rtree_->remove(old_new.first);
+            team_tree(old_new.first.second.team_id())->remove(old_new.first);
+            rtree_->insert(old_new.second);
+            team_tree(old_new.second.second.team_id())->insert(old_new.second);
+        }
+        for (point_id_t &value : added_) {
+            rtree_->insert(value);
+            team_tree(value.second.team_id())->insert(value);
         }
+        update_stats_.moved += num_changed;
+    }
+    added_.clear();
+    removed_.clear();
+    moved_.clear();
+
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    if (bulk) {
+        update_stats_.rebuilds++;
+        update_stats_.rebuild_time += dt.count();
+    } else {
+        update_stats_.updates++;
+        update_stats_.update_time += dt.count();
     }
-    results_to_neighbors(results, neighbors, self_id);
 }
 
-void RTree::neighbors_in_range(const Eigen::Vector3d &pos,
-                               std::vector<ID> &neighbors,
-                               double dist,
-                               int self_id, int team_id) {
+void RTree::rebuild() {
+    if (index_) {
+        index_->clear();
+        for (const point_id_t &value : entries_) {
+            const point &p = value.first;
+            index_->add(Eigen::Vector3d(bg::get<0>(p), bg::get<1>(p), bg::get<2>(p)),
+                        value.second);
+        }
+        return;
+    }
+
+    // The range constructor packs the tree, which is faster than inserting
+    // the values one at a time and gives better query performance.
+    scratch_.assign(entries_.begin(), entries_.end());
+    *rtree_ = rtree_t(scratch_.begin(), scratch_.end(), bgi::dynamic_rstar(size_));
+
+    auto by_team = [](const point_id_t &a, const point_id_t &b) {
+        return a.second.team_id() < b.second.team_id();
+    };
+    std::stable_sort(scratch_.begin(), scratch_.end(), by_team);
+
+    for (auto &kv : rtree_team_) {
+        kv.second->clear();
+    }
+    auto begin = scratch_.begin();
+    while (begin != scratch_.end()) {
+        auto end = std::upper_bound(begin, scratch_.end(), *begin, by_team);
+        *team_tree(begin->second.team_id()) =
+            rtree_t(begin, end, bgi::dynamic_rstar(size_));
+        begin = end;
+    }
+}
+
+rtree_t *RTree::query_tree(int team_id) {
+    if (team_id == -1) return rtree_.get();
+    auto it = rtree_team_.find(team_id);
+    return it == rtree_team_.end() ? nullptr : it->second.get();
+}
+
+namespace {
+
+// Calls func(value, squared distance) for each value within dist of pos,
+// without collecting the results into a container first.
+template <class Func>
+void query_range(rtree_t &tree, const Eigen::Vector3d &pos, double dist,
+                 int self_id, Func &&func) {
     // see here: http://stackoverflow.com/a/22910447
-    std::list<point_id_t> results;
     double x = pos(0);
     double y = pos(1);
     double z = pos(2);
@@ -124,27 +237,249 @@ void RTree::neighbors_in_range(const Eigen::Vector3d &pos,
         point(x - dist, y - dist, z - dist), point(x + dist, y + dist, z + dist)
     );
 
-    auto dist_func = [&](point_id_t const& v) {return bg::distance(v.first, sought) < dist;};
+    const double dist_sq = dist * dist;
+    auto visit = [&](const point_id_t &v) {
+        if (self_id >= 0 && v.second.id() == self_id) return;
+        double d_sq = bg::comparable_distance(v.first, sought);
+        if (d_sq < dist_sq) func(v, d_sq);
+    };
+    tree.query(bgi::within(box), boost::make_function_output_iterator(visit));
+}
 
-    if (team_id == -1) {
-        rtree_->query(
-            bgi::within(box) && bgi::satisfies(dist_func),
-            std::front_inserter(results)
-        );
-    } else {
-        auto it = rtree_team_.find(team_id);
-        if (it == rtree_team_.end()) {
-            neighbors.clear();
-            return;
-        } else {
-            it->second->query(
-                bgi::within(box) && bgi::satisfies(dist_func),
-                std::front_inserter(results)
-            );
+template <class Func>
+void query_nearest(rtree_t &tree, const Eigen::Vector3d &pos, unsigned int n,
+                   int self_id, Func &&func) {
+    point sought(pos(0), pos(1), pos(2));
+
+    if (self_id != -1) {
+        // assume that if an id is given then it will be located at pos so
+        // would always be in the neighborhood
+        n += 1;
+    }
+
+    auto visit = [&](const point_id_t &v) {
+        if (self_id >= 0 && v.second.id() == self_id) return;
+        func(v, bg::comparable_distance(v.first, sought));
+    };
+    tree.query(bgi::nearest(sought, n), boost::make_function_output_iterator(visit));
+}
+
+} // namespace
+
+void RTree::nearest_n_neighbors(const Eigen::Vector3d &pos,
+                                std::vector<ID> &neighbors, unsigned int n,
+                                int self_id, int team_id) {
+    if (index_) {
+        index_->nearest_n_neighbors(pos, neighbors, n, self_id, team_id);
+        return;
+    }
+
+    neighbors.clear();
+    rtree_t *tree = query_tree(team_id);
+    if (tree == nullptr) return;
+
+    query_nearest(*tree, pos, n, self_id, [&](const point_id_t &v, double) {
+        neighbors.push_back(v.second);
+    });
+    // keep the order that callers got when the results went through a list
+    // with a front_inserter
+    std::reverse(neighbors.begin(), neighbors.end());
+}
+
+void RTree::nearest_n_neighbors(const Eigen::Vector3d &pos,
+                                std::vector<Neighbor> &neighbors, unsigned int n,
+                                int self_id, int team_id) {
+    if (index_) {
+        index_->nearest_n_neighbors(pos, neighbors, n, self_id, team_id);
+        return;
+    }
+
+    neighbors.clear();
+    rtree_t *tree = query_tree(team_id);
+    if (tree == nullptr) return;
+
+    query_nearest(*tree, pos, n, self_id, [&](const point_id_t &v, double d_sq) {
+        neighbors.push_back(Neighbor{v.second, d_sq});
+    });
+}
+
+void RTree::neighbors_in_range(const Eigen::Vector3d &pos,
+                               std::vector<ID> &neighbors,
+                               double dist,
+                               int self_id, int team_id) {
+    if (index_) {
+        index_->neighbors_in_range(pos, neighbors, dist, self_id, team_id);
+        return;
+    }
+
+    neighbors.clear();
+    rtree_t *tree = query_tree(team_id);
+    if (tree == nullptr) return;
+
+    query_range(*tree, pos, dist, self_id, [&](const point_id_t &v, double) {
+        neighbors.push_back(v.second);
+    });
+    std::reverse(neighbors.begin(), neighbors.end());
+}
+
+void RTree::neighbors_in_range(const Eigen::Vector3d &pos,
+                               std::vector<Neighbor> &neighbors,
+                               double dist,
+                               int self_id, int team_id) {
+    if (index_) {
+        index_->neighbors_in_range(pos, neighbors, dist, self_id, team_id);
+        return;
+    }
+
+    neighbors.clear();
+    rtree_t *tree = query_tree(team_id);
+    if (tree == nullptr) return;
+
+    query_range(*tree, pos, dist, self_id, [&](const point_id_t &v, double d_sq) {
+        neighbors.push_back(Neighbor{v.second, d_sq});
+    });
+}
+
+void RTree::for_each_in_range(const Eigen::Vector3d &pos, double dist,
+                              const NeighborFunc &func,
+                              int self_id, int team_id) {
+    if (index_) {
+        index_->for_each_in_range(pos, dist, func, self_id, team_id);
+        return;
+    }
+
+    rtree_t *tree = query_tree(team_id);
+    if (tree == nullptr) return;
+
+    query_range(*tree, pos, dist, self_id, [&](const point_id_t &v, double d_sq) {
+        func(v.second, d_sq);
+    });
+}
+
+int RTree::register_neighbor_radius(double radius) {
+    auto it = std::find(radii_.begin(), radii_.end(), radius);
+    if (it != radii_.end()) {
+        return static_cast<int>(it - radii_.begin());
+    }
+    radii_.push_back(radius);
+    lists_valid_ = false;
+    return static_cast<int>(radii_.size()) - 1;
+}
+
+size_t RTree::begin_neighbor_lists(int num_threads) {
+    const size_t num_radii = radii_.size();
+
+    rows_.clear();
+    std::fill(row_of_id_.begin(), row_of_id_.end(), -1);
+    for (const point_id_t &value : entries_) {
+        const int id = value.second.id();
+        if (id < 0) continue;
+        if (static_cast<size_t>(id) >= row_of_id_.size()) {
+            row_of_id_.resize(id + 1, -1);
+        }
+        row_of_id_[id] = static_cast<int>(rows_.size());
+        rows_.push_back(value);
+    }
+
+    thread_lists_.resize(std::max(1, num_threads));
+    for (ThreadLists &tl : thread_lists_) {
+        tl.rows.clear();
+        tl.counts.resize(num_radii);
+        tl.hits.resize(num_radii);
+        for (size_t r = 0; r < num_radii; r++) {
+            tl.counts[r].clear();
+            tl.hits[r].clear();
         }
     }
+    return rows_.size();
+}
+
+void RTree::compute_neighbor_lists(size_t begin, size_t end, int thread_id) {
+    ThreadLists &tl = thread_lists_[thread_id];
+    const size_t num_radii = radii_.size();
+    if (num_radii == 0) return;
+
+    // one query at the largest radius gives the lists for all of the radii
+    const double max_radius = *std::max_element(radii_.begin(), radii_.end());
+    NeighborFunc collect = [&tl](const ID &id, double dist_sq) {
+        tl.scratch.push_back(Neighbor{id, dist_sq});
+    };
+
+    for (size_t row = begin; row < end; row++) {
+        const point &p = rows_[row].first;
+        const ID &id = rows_[row].second;
+        Eigen::Vector3d pos(bg::get<0>(p), bg::get<1>(p), bg::get<2>(p));
+
+        tl.scratch.clear();
+        for_each_in_range(pos, max_radius, collect, id.id());
+
+        tl.rows.push_back(static_cast<uint32_t>(row));
+        for (size_t r = 0; r < num_radii; r++) {
+            const double radius_sq = radii_[r] * radii_[r];
+            std::vector<Neighbor> &hits = tl.hits[r];
+            const size_t prev_size = hits.size();
+            for (const Neighbor &n : tl.scratch) {
+                if (n.dist_sq < radius_sq) hits.push_back(n);
+            }
+            tl.counts[r].push_back(static_cast<uint32_t>(hits.size() - prev_size));
+        }
+    }
+}
+
+void RTree::finish_neighbor_lists() {
+    const size_t num_radii = radii_.size();
+    const size_t num_rows = rows_.size();
+    offsets_.resize(num_radii);
+    lists_.resize(num_radii);
+
+    for (size_t r = 0; r < num_radii; r++) {
+        std::vector<uint32_t> &offsets = offsets_[r];
+        offsets.assign(num_rows + 1, 0);
+        for (ThreadLists &tl : thread_lists_) {
+            for (size_t i = 0; i < tl.rows.size(); i++) {
+                offsets[tl.rows[i] + 1] = tl.counts[r][i];
+            }
+        }
+        for (size_t i = 1; i <= num_rows; i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        // each thread has its rows' hits back to back in the order it
+        // computed the rows
+        std::vector<Neighbor> &list = lists_[r];
+        list.resize(offsets[num_rows]);
+        for (ThreadLists &tl : thread_lists_) {
+            auto src = tl.hits[r].begin();
+            for (size_t i = 0; i < tl.rows.size(); i++) {
+                const uint32_t count = tl.counts[r][i];
+                std::copy(src, src + count, list.begin() + offsets[tl.rows[i]]);
+                src += count;
+            }
+        }
+    }
+    lists_valid_ = true;
+}
+
+void RTree::compute_neighbor_lists() {
+    size_t n = begin_neighbor_lists(1);
+    compute_neighbor_lists(0, n, 0);
+    finish_neighbor_lists();
+}
+
+bool RTree::neighbor_list(int radius_id, int entity_id, NeighborList &list) const {
+    if (!lists_valid_ || radius_id < 0 ||
+        static_cast<size_t>(radius_id) >= lists_.size() ||
+        entity_id < 0 || static_cast<size_t>(entity_id) >= row_of_id_.size()) {
+        return false;
+    }
+
+    const int row = row_of_id_[entity_id];
+    if (row < 0) return false;
 
-    results_to_neighbors(results, neighbors, self_id);
+    const std::vector<uint32_t> &offsets = offsets_[radius_id];
+    const Neighbor *data = lists_[radius_id].data();
+    list = NeighborList(data + offsets[row], data + offsets[row + 1]);
+    return true;
 }
 
 } // namespace scrimmage
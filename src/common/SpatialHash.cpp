@@ -0,0 +1,312 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+#include <scrimmage/common/SpatialHash.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace scrimmage {
+
+namespace {
+// radius bin 0 holds radii below 2^-bin_offset
+constexpr int bin_offset = 32;
+} // namespace
+
+SpatialHash::SpatialHash(double cell_size) :
+        adaptive_(cell_size <= 0), cell_size_(cell_size > 0 ? cell_size : 1.0) {
+    for (auto &count : radius_counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    min_.setZero();
+    max_.setZero();
+}
+
+void SpatialHash::init(int size) {
+    if (size > 0) {
+        entries_.reserve(size);
+        sorted_.reserve(size);
+    }
+}
+
+void SpatialHash::clear() {
+    entries_.clear();
+    dirty_.store(true, std::memory_order_release);
+}
+
+void SpatialHash::add(const Eigen::Vector3d &pos, const ID &id) {
+    entries_.push_back(Entry{pos, id, Cell{{0, 0, 0}}});
+    dirty_.store(true, std::memory_order_release);
+}
+
+SpatialHash::Cell SpatialHash::cell(const Eigen::Vector3d &pos) const {
+    return Cell{{static_cast<int64_t>(std::floor(pos(0) / cell_size_)),
+                 static_cast<int64_t>(std::floor(pos(1) / cell_size_)),
+                 static_cast<int64_t>(std::floor(pos(2) / cell_size_))}};
+}
+
+size_t SpatialHash::bucket(const Cell &c) const {
+    const uint64_t h = (static_cast<uint64_t>(c[0]) * 73856093ull) ^
+        (static_cast<uint64_t>(c[1]) * 19349663ull) ^
+        (static_cast<uint64_t>(c[2]) * 83492791ull);
+    return static_cast<size_t>(h) & mask_;
+}
+
+void SpatialHash::ensure_built() {
+    if (dirty_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(build_mutex_);
+        if (dirty_.load(std::memory_order_relaxed)) {
+            build();
+            dirty_.store(false, std::memory_order_release);
+        }
+    }
+}
+
+void SpatialHash::build() {
+    sorted_.clear();
+    if (entries_.empty()) return;
+
+    min_ = entries_.front().pos;
+    max_ = entries_.front().pos;
+    for (const Entry &e : entries_) {
+        min_ = min_.cwiseMin(e.pos);
+        max_ = max_.cwiseMax(e.pos);
+    }
+
+    if (adaptive_) {
+        // use the most common query radius, halving the old counts so that
+        // the cell size follows changes in the queries
+        int best = -1;
+        uint32_t best_count = 0;
+        for (int i = 0; i < num_radius_bins; i++) {
+            uint32_t count = radius_counts_[i].load(std::memory_order_relaxed);
+            if (count > best_count) {
+                best = i;
+                best_count = count;
+            }
+            radius_counts_[i].store(count / 2, std::memory_order_relaxed);
+        }
+
+        if (best >= 0) {
+            cell_size_ = std::ldexp(1.0, best - bin_offset);
+        } else {
+            // no range queries yet, aim for about one entity per cell
+            double extent = (max_ - min_).maxCoeff();
+            double size = extent / std::cbrt(static_cast<double>(entries_.size()));
+            cell_size_ = size > 0 ? size : 1.0;
+        }
+    }
+
+    // at least two buckets per entity keeps the chains short
+    size_t num_buckets = 16;
+    while (num_buckets < 2 * entries_.size()) num_buckets *= 2;
+    mask_ = num_buckets - 1;
+
+    // counting sort by bucket. After the scatter, bucket_start_[b] is the end
+    // of bucket b, so the starts are shifted up by one.
+    bucket_start_.assign(num_buckets + 1, 0);
+    for (Entry &e : entries_) {
+        e.cell = cell(e.pos);
+        bucket_start_[bucket(e.cell) + 1]++;
+    }
+    for (size_t b = 1; b <= num_buckets; b++) {
+        bucket_start_[b] += bucket_start_[b - 1];
+    }
+
+    sorted_.resize(entries_.size());
+    for (const Entry &e : entries_) {
+        sorted_[bucket_start_[bucket(e.cell)]++] = e;
+    }
+    for (size_t b = num_buckets; b > 0; b--) {
+        bucket_start_[b] = bucket_start_[b - 1];
+    }
+    bucket_start_[0] = 0;
+}
+
+template <class Func>
+void SpatialHash::visit_range(const Eigen::Vector3d &pos, double dist,
+                              int team_id, Func &&func) const {
+    const double dist_sq = dist * dist;
+    auto visit = [&](const Entry &e) {
+        if (team_id != -1 && e.id.team_id() != team_id) return;
+        double d_sq = (e.pos - pos).squaredNorm();
+        if (d_sq < dist_sq) func(e, d_sq);
+    };
+
+    const Eigen::Vector3d lo = pos.array() - dist;
+    const Eigen::Vector3d hi = pos.array() + dist;
+    const Cell c_lo = cell(lo.cwiseMax(min_));
+    const Cell c_hi = cell(hi.cwiseMin(max_));
+
+    double num_cells = 1;
+    for (int i = 0; i < 3; i++) {
+        if (c_hi[i] < c_lo[i]) return; // the query misses the bounding box
+        num_cells *= static_cast<double>(c_hi[i] - c_lo[i] + 1);
+    }
+
+    if (num_cells > static_cast<double>(sorted_.size())) {
+        // the query covers more cells than there are entities
+        for (const Entry &e : sorted_) visit(e);
+        return;
+    }
+
+    Cell c;
+    for (c[0] = c_lo[0]; c[0] <= c_hi[0]; c[0]++) {
+        for (c[1] = c_lo[1]; c[1] <= c_hi[1]; c[1]++) {
+            for (c[2] = c_lo[2]; c[2] <= c_hi[2]; c[2]++) {
+                const size_t b = bucket(c);
+                for (uint32_t i = bucket_start_[b]; i < bucket_start_[b + 1]; i++) {
+                    // other cells can share the bucket
+                    if (sorted_[i].cell == c) visit(sorted_[i]);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::record_radius(double dist) {
+    if (adaptive_ && dist > 0) {
+        int bin = std::ilogb(dist) + 1 + bin_offset;
+        bin = std::min(std::max(bin, 0), num_radius_bins - 1);
+        radius_counts_[bin].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SpatialHash::neighbors_in_range(const Eigen::Vector3d &pos,
+                                     std::vector<ID> &neighbors, double dist,
+                                     int self_id, int team_id) {
+    record_radius(dist);
+    ensure_built();
+    neighbors.clear();
+    if (sorted_.empty()) return;
+
+    visit_range(pos, dist, team_id, [&](const Entry &e, double) {
+        if (self_id < 0 || e.id.id() != self_id) neighbors.push_back(e.id);
+    });
+}
+
+void SpatialHash::neighbors_in_range(const Eigen::Vector3d &pos,
+                                     std::vector<Neighbor> &neighbors, double dist,
+                                     int self_id, int team_id) {
+    record_radius(dist);
+    ensure_built();
+    neighbors.clear();
+    if (sorted_.empty()) return;
+
+    visit_range(pos, dist, team_id, [&](const Entry &e, double d_sq) {
+        if (self_id < 0 || e.id.id() != self_id) neighbors.push_back(Neighbor{e.id, d_sq});
+    });
+}
+
+void SpatialHash::for_each_in_range(const Eigen::Vector3d &pos, double dist,
+                                    const NeighborFunc &func,
+                                    int self_id, int team_id) {
+    record_radius(dist);
+    ensure_built();
+    if (sorted_.empty()) return;
+
+    visit_range(pos, dist, team_id, [&](const Entry &e, double d_sq) {
+        if (self_id < 0 || e.id.id() != self_id) func(e.id, d_sq);
+    });
+}
+
+template <class Func>
+void SpatialHash::visit_nearest(const Eigen::Vector3d &pos, unsigned int n,
+                                int self_id, int team_id, Func &&func) {
+    ensure_built();
+    if (sorted_.empty() || n == 0) return;
+
+    if (self_id != -1) {
+        // same as the RTree, assume that the entity with self_id is at pos
+        n += 1;
+    }
+
+    // The search radius doubles until it holds n candidates. Anything outside
+    // the radius is farther away than all of the candidates, so the n nearest
+    // candidates are the n nearest overall.
+    double max_dist_sq = 0;
+    for (int i = 0; i < 8; i++) {
+        Eigen::Vector3d corner((i & 1) ? max_(0) : min_(0),
+                               (i & 2) ? max_(1) : min_(1),
+                               (i & 4) ? max_(2) : min_(2));
+        max_dist_sq = std::max(max_dist_sq, (corner - pos).squaredNorm());
+    }
+    // the last radius must include entities exactly on the farthest corner
+    const double max_dist = std::sqrt(max_dist_sq) + cell_size_;
+
+    const Eigen::Vector3d closest = pos.cwiseMax(min_).cwiseMin(max_);
+    double radius = std::min((closest - pos).norm() + cell_size_, max_dist);
+
+    // reused between queries, which can come from several threads
+    thread_local std::vector<std::pair<double, ID>> candidates;
+    while (true) {
+        candidates.clear();
+        visit_range(pos, radius, team_id, [&](const Entry &e, double d_sq) {
+            candidates.emplace_back(d_sq, e.id);
+        });
+        if (candidates.size() >= n || radius >= max_dist) break;
+        radius = std::min(2 * radius, max_dist);
+    }
+
+    auto by_dist = [](const std::pair<double, ID> &a, const std::pair<double, ID> &b) {
+        return a.first < b.first;
+    };
+    const size_t num = std::min(static_cast<size_t>(n), candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + num,
+                      candidates.end(), by_dist);
+
+    for (size_t i = 0; i < num; i++) {
+        if (self_id < 0 || candidates[i].second.id() != self_id) {
+            func(candidates[i].second, candidates[i].first);
+        }
+    }
+}
+
+void SpatialHash::nearest_n_neighbors(const Eigen::Vector3d &pos,
+                                      std::vector<ID> &neighbors, unsigned int n,
+                                      int self_id, int team_id) {
+    neighbors.clear();
+    visit_nearest(pos, n, self_id, team_id, [&](const ID &id, double) {
+        neighbors.push_back(id);
+    });
+}
+
+void SpatialHash::nearest_n_neighbors(const Eigen::Vector3d &pos,
+                                      std::vector<Neighbor> &neighbors, unsigned int n,
+                                      int self_id, int team_id) {
+    neighbors.clear();
+    visit_nearest(pos, n, self_id, team_id, [&](const ID &id, double d_sq) {
+        neighbors.push_back(Neighbor{id, d_sq});
+    });
+}
+
+} // namespace scrimmage
@@ -0,0 +1,197 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/common/TaskScheduler.h>
+
+#include <algorithm>
+#include <chrono> // NOLINT
+
+namespace scrimmage {
+
+namespace {
+double seconds_since(const std::chrono::steady_clock::time_point &t0) {
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    return dt.count();
+}
+} // namespace
+
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+
+void TaskScheduler::start(int num_threads, size_t chunk_size) {
+    stop();
+
+    stop_ = false;
+    chunk_size_ = chunk_size;
+    num_threads = std::max(num_threads, 1);
+
+    queues_.clear();
+    for (int i = 0; i < num_threads; i++) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    threads_.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; i++) {
+        threads_.push_back(std::thread(&TaskScheduler::worker, this, i));
+    }
+}
+
+void TaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (std::thread &t : threads_) {
+        t.join();
+    }
+    threads_.clear();
+}
+
+bool TaskScheduler::run(const std::string &phase, size_t n, const RangeFunc &func) {
+    if (n == 0) return true;
+
+    auto t0 = std::chrono::steady_clock::now();
+    PhaseStats &stats = stats_[phase];
+    stats.count++;
+
+    if (threads_.empty()) {
+        bool success = func(0, n, 0);
+        double dt = seconds_since(t0);
+        stats.wall_time += dt;
+        stats.busy_time += dt;
+        return success;
+    }
+
+    const size_t num_queues = queues_.size();
+    {
+        // A worker that woke up late for the previous phase may still be
+        // scanning the queues, so wait for it before dealing new chunks.
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] {return busy_workers_ == 0;});
+
+        func_ = &func;
+        n_ = n;
+        phase_chunk_size_ = chunk_size_ > 0 ?
+            chunk_size_ : std::max<size_t>(1, n / (4 * num_queues));
+
+        const size_t num_chunks = (n + phase_chunk_size_ - 1) / phase_chunk_size_;
+        for (size_t i = 0; i < num_queues; i++) {
+            WorkQueue &q = *queues_[i];
+            q.front = num_chunks * i / num_queues;
+            q.back = num_chunks * (i + 1) / num_queues;
+            q.busy_time = 0;
+            q.success = true;
+        }
+        epoch_++;
+    }
+    start_cv_.notify_all();
+
+    drain(0);
+
+    bool success = true;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] {return busy_workers_ == 0;});
+        for (auto &q : queues_) {
+            stats.busy_time += q->busy_time;
+            success &= q->success;
+        }
+        func_ = nullptr;
+    }
+    stats.wall_time += seconds_since(t0);
+    return success;
+}
+
+void TaskScheduler::worker(int id) {
+    uint64_t seen_epoch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] {return stop_ || epoch_ != seen_epoch;});
+            if (stop_) return;
+            seen_epoch = epoch_;
+            busy_workers_++;
+        }
+
+        drain(id);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_workers_--;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void TaskScheduler::drain(int id) {
+    auto t0 = std::chrono::steady_clock::now();
+    WorkQueue &q = *queues_[id];
+
+    // A worker that wakes up after the phase has already been drained must
+    // not touch its queue, since the caller may be reading the stats.
+    size_t chunk;
+    bool worked = false;
+    while (pop(id, chunk) || steal(id, chunk)) {
+        worked = true;
+        size_t begin = chunk * phase_chunk_size_;
+        size_t end = std::min(begin + phase_chunk_size_, n_);
+        if (!(*func_)(begin, end, id)) {
+            q.success = false;
+        }
+    }
+    if (worked) q.busy_time += seconds_since(t0);
+}
+
+bool TaskScheduler::pop(int id, size_t &chunk) {
+    WorkQueue &q = *queues_[id];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.front == q.back) return false;
+    chunk = q.front++;
+    return true;
+}
+
+bool TaskScheduler::steal(int id, size_t &chunk) {
+    const int num_queues = static_cast<int>(queues_.size());
+    for (int i = 1; i < num_queues; i++) {
+        WorkQueue &q = *queues_[(id + i) % num_queues];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.front != q.back) {
+            chunk = --q.back;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace scrimmage
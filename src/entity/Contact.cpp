@@ -36,6 +36,8 @@
 
 #include <memory>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
 namespace scrimmage {
 
@@ -45,7 +47,8 @@ Contact::Contact(ID &id, double radius, StatePtr &state, Type type,
                  scrimmage_proto::ContactVisualPtr cv,
                  const std::unordered_map<std::string, MessageBasePtr> &properties) :
     id_(id), state_(state), type_(type), contact_visual_(cv),
-    active_(true), radius_(radius), properties_(properties) {}
+    active_(true), radius_(radius),
+    properties_(std::make_shared<const std::unordered_map<std::string, MessageBasePtr>>(properties)) {}
 
 void Contact::set_id(const ID &id) { id_ = id; }
 
@@ -66,8 +69,126 @@ void Contact::set_active(bool active) { active_ = active; }
 
 bool Contact::active() { return active_; }
 
+void Contact::set_properties(const std::unordered_map<std::string, MessageBasePtr> &properties) {
+    properties_ = std::make_shared<const std::unordered_map<std::string, MessageBasePtr>>(properties);
+}
+
 std::ostream& operator<<(std::ostream& os, const Contact& c) {
     os << c.id_ << ": " << *c.state_;
     return os;
 }
+
+void ContactMap::clear() {
+    slots_.clear();
+    generations_.clear();
+    used_.clear();
+    free_slots_.clear();
+    id_to_slot_.clear();
+    sparse_id_to_slot_.clear();
+    size_ = 0;
+}
+
+void ContactMap::reserve(size_t n) {
+    slots_.reserve(n);
+    generations_.reserve(n);
+    used_.reserve(n);
+}
+
+ContactMap::iterator ContactMap::find(int id) {
+    int s = slot(id);
+    return s < 0 ? end() : iterator(this, s);
+}
+
+ContactMap::const_iterator ContactMap::find(int id) const {
+    int s = slot(id);
+    return s < 0 ? end() : const_iterator(this, s);
+}
+
+Contact &ContactMap::at(int id) {
+    int s = slot(id);
+    if (s < 0) {
+        throw std::out_of_range("ContactMap::at: no contact with id " + std::to_string(id));
+    }
+    return slots_[s].second;
+}
+
+const Contact &ContactMap::at(int id) const {
+    return const_cast<ContactMap *>(this)->at(id);
+}
+
+Contact &ContactMap::operator[](int id) {
+    int s = slot(id);
+    if (s >= 0) return slots_[s].second;
+
+    if (free_slots_.empty()) {
+        s = num_slots();
+        slots_.emplace_back(id, Contact());
+        generations_.push_back(0);
+        used_.push_back(true);
+    } else {
+        s = free_slots_.back();
+        free_slots_.pop_back();
+        slots_[s].first = id;
+        used_[s] = true;
+    }
+    set_slot(id, s);
+    size_++;
+    return slots_[s].second;
+}
+
+size_t ContactMap::erase(int id) {
+    int s = slot(id);
+    if (s < 0) return 0;
+
+    // release the state, visual, etc.
+    slots_[s].second = Contact();
+    used_[s] = false;
+    generations_[s]++;
+    free_slots_.push_back(s);
+    set_slot(id, -1);
+    size_--;
+    return 1;
+}
+
+ContactMap::iterator ContactMap::erase(const_iterator it) {
+    int s = it.slot();
+    erase(slots_[s].first);
+    return iterator(this, s + 1);
+}
+
+int ContactMap::slot(int id) const {
+    if (id >= 0 && id < max_direct_id) {
+        return static_cast<size_t>(id) < id_to_slot_.size() ? id_to_slot_[id] : -1;
+    }
+    auto it = sparse_id_to_slot_.find(id);
+    return it == sparse_id_to_slot_.end() ? -1 : it->second;
+}
+
+void ContactMap::set_slot(int id, int slot) {
+    if (id >= 0 && id < max_direct_id) {
+        if (static_cast<size_t>(id) >= id_to_slot_.size()) {
+            id_to_slot_.resize(id + 1, -1);
+        }
+        id_to_slot_[id] = slot;
+    } else if (slot < 0) {
+        sparse_id_to_slot_.erase(id);
+    } else {
+        sparse_id_to_slot_[id] = slot;
+    }
+}
+
+ContactMap::Handle ContactMap::handle(int id) const {
+    Handle h;
+    h.slot = slot(id);
+    if (h.slot >= 0) h.generation = generations_[h.slot];
+    return h;
+}
+
+Contact *ContactMap::get(const Handle &handle) {
+    if (handle.slot < 0 || handle.slot >= num_slots() ||
+            !used_[handle.slot] || generations_[handle.slot] != handle.generation) {
+        return nullptr;
+    }
+    return &slots_[handle.slot].second;
+}
 } // namespace scrimmage
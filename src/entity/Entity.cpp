@@ -34,6 +34,7 @@
 #include <scrimmage/common/Utilities.h>
 #include <scrimmage/entity/Entity.h>
 #include <scrimmage/math/State.h>
+#include <scrimmage/math/StateStore.h>
 #include <scrimmage/math/Angles.h>
 #include <scrimmage/motion/MotionModel.h>
 #include <scrimmage/motion/Controller.h>
@@ -121,6 +122,10 @@ bool Entity::init(AttributeMap &overrides,
     double yaw = Angles::deg2rad(get("heading", info, 0.0));
     state_->quat().set(roll, pitch, yaw);
 
+    if (state_store_) {
+        state_store_->add(*state_, id_);
+    }
+
     EntityPtr parent = shared_from_this();
 
     ConfigParse config_parse;
@@ -394,6 +399,10 @@ void Entity::set_random(RandomPtr random) { random_ = random; }
 
 RandomPtr Entity::random() { return random_; }
 
+void Entity::set_state_store(StateStorePtr state_store) {
+    state_store_ = state_store;
+}
+
 Contact::Type Entity::type() { return type_; }
 
 void Entity::set_visual_changed(bool visual_changed)
@@ -494,6 +503,13 @@ void Entity::close(double t) {
     mp_ = nullptr;
     proj_ = nullptr;
     random_ = nullptr;
+
+    // Other plugins may still hold the state, so its values are copied out
+    // of the store before the slot is reused.
+    if (state_store_ && state_) {
+        state_store_->remove(*state_);
+    }
+    state_store_ = nullptr;
     state_ = nullptr;
     properties_.clear();
     sensors_.clear();
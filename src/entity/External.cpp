@@ -102,8 +102,7 @@ bool External::create_entity(int max_entities, int entity_id,
     }
 
     // Load the network names (don't need to load the network plugins)
-    pubsub_->pubs().clear();
-    pubsub_->subs().clear();
+    pubsub_->clear();
     for (std::string network_name : mp_->network_names()) {
         // Seed the pubsub with network names
         std::string aliased_name = network_name;
@@ -0,0 +1,366 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/log/ColumnarLog.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+namespace sp = scrimmage_proto;
+
+namespace scrimmage {
+
+namespace {
+const char header_magic[8] = {'S', 'C', 'R', 'C', 'O', 'L', '0', '2'};
+const char chunk_magic[8] = {'S', 'C', 'R', 'C', 'O', 'L', 'C', 'H'};
+const char index_magic[8] = {'S', 'C', 'R', 'C', 'O', 'L', 'I', 'X'};
+const uint64_t chunk_header_size = 2 * sizeof(uint32_t);
+
+static_assert(sizeof(ColumnarChunkInfo) == 32, "ColumnarChunkInfo is written as is");
+
+template <class T>
+void write_values(std::ofstream &output, const std::vector<T> &values) {
+    output.write(reinterpret_cast<const char *>(values.data()),
+                 values.size() * sizeof(T));
+}
+} // namespace
+
+void ColumnarChunk::clear() {
+    time.clear();
+    row_begin.clear();
+    id.clear();
+    sub_swarm_id.clear();
+    team_id.clear();
+    type.clear();
+    active.clear();
+    for (auto *v : {&pos_x, &pos_y, &pos_z, &vel_x, &vel_y, &vel_z,
+                    &quat_w, &quat_x, &quat_y, &quat_z}) {
+        v->clear();
+    }
+}
+
+void ColumnarChunk::add_frame(const sp::Frame &frame) {
+    if (row_begin.empty()) row_begin.push_back(0);
+    time.push_back(frame.time());
+    for (int i = 0; i < frame.contact_size(); i++) {
+        const sp::Contact &c = frame.contact(i);
+        const sp::State &s = c.state();
+        id.push_back(c.id().id());
+        sub_swarm_id.push_back(c.id().sub_swarm_id());
+        team_id.push_back(c.id().team_id());
+        type.push_back(static_cast<uint8_t>(c.type()));
+        active.push_back(c.active());
+        pos_x.push_back(s.position().x());
+        pos_y.push_back(s.position().y());
+        pos_z.push_back(s.position().z());
+        vel_x.push_back(s.velocity().x());
+        vel_y.push_back(s.velocity().y());
+        vel_z.push_back(s.velocity().z());
+        quat_w.push_back(s.orientation().w());
+        quat_x.push_back(s.orientation().x());
+        quat_y.push_back(s.orientation().y());
+        quat_z.push_back(s.orientation().z());
+    }
+    row_begin.push_back(static_cast<uint32_t>(id.size()));
+}
+
+std::shared_ptr<sp::Frame> ColumnarChunk::frame(size_t i) const {
+    auto frame = std::make_shared<sp::Frame>();
+    frame->set_time(time[i]);
+    for (uint32_t r = row_begin[i]; r < row_begin[i + 1]; r++) {
+        sp::Contact *c = frame->add_contact();
+        sp::State *s = c->mutable_state();
+        s->mutable_position()->set_x(pos_x[r]);
+        s->mutable_position()->set_y(pos_y[r]);
+        s->mutable_position()->set_z(pos_z[r]);
+        s->mutable_velocity()->set_x(vel_x[r]);
+        s->mutable_velocity()->set_y(vel_y[r]);
+        s->mutable_velocity()->set_z(vel_z[r]);
+        s->mutable_orientation()->set_x(quat_x[r]);
+        s->mutable_orientation()->set_y(quat_y[r]);
+        s->mutable_orientation()->set_z(quat_z[r]);
+        s->mutable_orientation()->set_w(quat_w[r]);
+        c->set_type(static_cast<sp::ContactType>(type[r]));
+        c->set_active(active[r] != 0);
+        c->mutable_id()->set_id(id[r]);
+        c->mutable_id()->set_sub_swarm_id(sub_swarm_id[r]);
+        c->mutable_id()->set_team_id(team_id[r]);
+    }
+    return frame;
+}
+
+size_t ColumnarChunk::value_size(Column column) {
+    switch (column) {
+    case ROW_BEGIN: return sizeof(uint32_t);
+    case ID: case SUB_SWARM_ID: case TEAM_ID: return sizeof(int32_t);
+    case TYPE: case ACTIVE: return sizeof(uint8_t);
+    default: return sizeof(double);
+    }
+}
+
+uint64_t ColumnarChunk::column_offset(Column column, uint32_t num_frames,
+                                      uint32_t num_rows) {
+    uint64_t offset = chunk_header_size;
+    for (int c = TIME; c < column; c++) {
+        uint64_t n = c == TIME ? num_frames : c == ROW_BEGIN ? num_frames + 1 : num_rows;
+        offset += n * value_size(static_cast<Column>(c));
+    }
+    return offset;
+}
+
+ColumnarLogWriter::~ColumnarLogWriter() {
+    close();
+}
+
+bool ColumnarLogWriter::open(const std::string &filename, double chunk_duration) {
+    output_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!output_.is_open()) {
+        cout << "Failed to open file for writing: " << filename << endl;
+        return false;
+    }
+    output_.write(header_magic, sizeof(header_magic));
+    chunk_duration_ = chunk_duration;
+    chunk_.clear();
+    index_.clear();
+    return output_.good();
+}
+
+bool ColumnarLogWriter::write_frame(const sp::Frame &frame) {
+    if (!output_.is_open()) return false;
+
+    if (chunk_.num_frames() > 0 && frame.time() >= chunk_end_ && !write_chunk()) {
+        return false;
+    }
+    if (chunk_.num_frames() == 0) {
+        chunk_end_ = frame.time() + chunk_duration_;
+    }
+    chunk_.add_frame(frame);
+    return true;
+}
+
+bool ColumnarLogWriter::write_chunk() {
+    ColumnarChunkInfo info;
+    info.t_begin = chunk_.time.front();
+    info.t_end = chunk_.time.back();
+    info.offset = static_cast<uint64_t>(output_.tellp());
+    info.num_frames = static_cast<uint32_t>(chunk_.num_frames());
+    info.num_rows = static_cast<uint32_t>(chunk_.num_rows());
+    index_.push_back(info);
+
+    output_.write(reinterpret_cast<const char *>(&info.num_frames), sizeof(uint32_t));
+    output_.write(reinterpret_cast<const char *>(&info.num_rows), sizeof(uint32_t));
+    write_values(output_, chunk_.time);
+    write_values(output_, chunk_.row_begin);
+    write_values(output_, chunk_.id);
+    write_values(output_, chunk_.sub_swarm_id);
+    write_values(output_, chunk_.team_id);
+    write_values(output_, chunk_.type);
+    write_values(output_, chunk_.active);
+    for (auto *v : {&chunk_.pos_x, &chunk_.pos_y, &chunk_.pos_z,
+                    &chunk_.vel_x, &chunk_.vel_y, &chunk_.vel_z,
+                    &chunk_.quat_w, &chunk_.quat_x, &chunk_.quat_y, &chunk_.quat_z}) {
+        write_values(output_, *v);
+    }
+
+    // The footer lets a reader find the chunk if the index is never written
+    output_.write(reinterpret_cast<const char *>(&info), sizeof(info));
+    output_.write(chunk_magic, sizeof(chunk_magic));
+    output_.flush();
+    chunk_.clear();
+    return output_.good();
+}
+
+bool ColumnarLogWriter::close() {
+    if (!output_.is_open()) return true;
+
+    bool success = chunk_.num_frames() == 0 || write_chunk();
+    uint64_t index_offset = static_cast<uint64_t>(output_.tellp());
+    uint64_t num_chunks = index_.size();
+    write_values(output_, index_);
+    output_.write(reinterpret_cast<const char *>(&index_offset), sizeof(index_offset));
+    output_.write(reinterpret_cast<const char *>(&num_chunks), sizeof(num_chunks));
+    output_.write(index_magic, sizeof(index_magic));
+    success &= output_.good();
+    output_.close();
+    return success;
+}
+
+bool ColumnarLogReader::open(const std::string &filename) {
+    index_.clear();
+    input_.close();
+    input_.clear();
+    input_.open(filename, std::ios::binary);
+    if (!input_.is_open()) {
+        cout << "Failed to open file for reading: " << filename << endl;
+        return false;
+    }
+
+    char magic[8];
+    input_.read(magic, sizeof(magic));
+    if (!input_ || std::memcmp(magic, header_magic, sizeof(magic)) != 0) {
+        cout << "Not a columnar frame log: " << filename << endl;
+        return false;
+    }
+
+    if (!read_index()) {
+        cout << "Columnar frame log has no index (was it closed?), "
+             << "scanning its chunks: " << filename << endl;
+        scan_chunks();
+    }
+    return true;
+}
+
+bool ColumnarLogReader::read_index() {
+    // the trailer points to the index
+    char magic[8];
+    uint64_t index_offset = 0, num_chunks = 0;
+    input_.clear();
+    input_.seekg(-static_cast<std::streamoff>(2 * sizeof(uint64_t) + sizeof(magic)),
+                 std::ios::end);
+    input_.read(reinterpret_cast<char *>(&index_offset), sizeof(index_offset));
+    input_.read(reinterpret_cast<char *>(&num_chunks), sizeof(num_chunks));
+    input_.read(magic, sizeof(magic));
+    if (!input_ || std::memcmp(magic, index_magic, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    // The index runs from index_offset to the trailer. A trailer that
+    // doesn't agree is corrupt, so the chunks are scanned instead.
+    const uint64_t trailer_offset = static_cast<uint64_t>(input_.tellg()) -
+        (2 * sizeof(uint64_t) + sizeof(magic));
+    if (index_offset < sizeof(header_magic) || index_offset > trailer_offset ||
+        (trailer_offset - index_offset) % sizeof(ColumnarChunkInfo) != 0 ||
+        (trailer_offset - index_offset) / sizeof(ColumnarChunkInfo) != num_chunks) {
+        return false;
+    }
+
+    index_.resize(num_chunks);
+    input_.seekg(index_offset);
+    input_.read(reinterpret_cast<char *>(index_.data()),
+                num_chunks * sizeof(ColumnarChunkInfo));
+    if (!input_) index_.clear();
+    return static_cast<bool>(input_);
+}
+
+void ColumnarLogReader::scan_chunks() {
+    // Each chunk's size follows from its frame and row counts, so the chunks
+    // are walked from the header. The scan stops at the first chunk whose
+    // footer is missing, which is where the writer was cut off.
+    index_.clear();
+    uint64_t offset = sizeof(header_magic);
+    while (true) {
+        uint32_t counts[2];
+        input_.clear();
+        input_.seekg(offset);
+        input_.read(reinterpret_cast<char *>(counts), sizeof(counts));
+        if (!input_) break;
+
+        ColumnarChunkInfo info;
+        char magic[8];
+        input_.seekg(offset + ColumnarChunk::column_offset(
+            ColumnarChunk::NUM_COLUMNS, counts[0], counts[1]));
+        input_.read(reinterpret_cast<char *>(&info), sizeof(info));
+        input_.read(magic, sizeof(magic));
+        if (!input_ || std::memcmp(magic, chunk_magic, sizeof(magic)) != 0 ||
+            info.offset != offset || info.num_frames != counts[0] ||
+            info.num_rows != counts[1]) {
+            break;
+        }
+        index_.push_back(info);
+        offset = static_cast<uint64_t>(input_.tellg());
+    }
+    input_.clear();
+}
+
+size_t ColumnarLogReader::find_chunk(double t) const {
+    auto it = std::lower_bound(index_.begin(), index_.end(), t,
+        [](const ColumnarChunkInfo &info, double t) {return info.t_end < t;});
+    return it - index_.begin();
+}
+
+size_t ColumnarLogReader::num_values(size_t chunk, ColumnarChunk::Column column) const {
+    const ColumnarChunkInfo &info = index_[chunk];
+    switch (column) {
+    case ColumnarChunk::TIME: return info.num_frames;
+    case ColumnarChunk::ROW_BEGIN: return info.num_frames + 1;
+    default: return info.num_rows;
+    }
+}
+
+bool ColumnarLogReader::read_values(size_t chunk, ColumnarChunk::Column column,
+                                    void *values) {
+    if (chunk >= index_.size()) return false;
+    const ColumnarChunkInfo &info = index_[chunk];
+    input_.clear();
+    input_.seekg(info.offset + ColumnarChunk::column_offset(
+        column, info.num_frames, info.num_rows));
+    input_.read(static_cast<char *>(values),
+                num_values(chunk, column) * ColumnarChunk::value_size(column));
+    return static_cast<bool>(input_);
+}
+
+bool ColumnarLogReader::read_chunk(size_t chunk, ColumnarChunk &columns) {
+    using C = ColumnarChunk;
+    return read_column(chunk, C::TIME, columns.time) &&
+        read_column(chunk, C::ROW_BEGIN, columns.row_begin) &&
+        read_column(chunk, C::ID, columns.id) &&
+        read_column(chunk, C::SUB_SWARM_ID, columns.sub_swarm_id) &&
+        read_column(chunk, C::TEAM_ID, columns.team_id) &&
+        read_column(chunk, C::TYPE, columns.type) &&
+        read_column(chunk, C::ACTIVE, columns.active) &&
+        read_column(chunk, C::POS_X, columns.pos_x) &&
+        read_column(chunk, C::POS_Y, columns.pos_y) &&
+        read_column(chunk, C::POS_Z, columns.pos_z) &&
+        read_column(chunk, C::VEL_X, columns.vel_x) &&
+        read_column(chunk, C::VEL_Y, columns.vel_y) &&
+        read_column(chunk, C::VEL_Z, columns.vel_z) &&
+        read_column(chunk, C::QUAT_W, columns.quat_w) &&
+        read_column(chunk, C::QUAT_X, columns.quat_x) &&
+        read_column(chunk, C::QUAT_Y, columns.quat_y) &&
+        read_column(chunk, C::QUAT_Z, columns.quat_z);
+}
+
+std::shared_ptr<sp::Frame> ColumnarLogReader::read_frame(double t) {
+    size_t chunk = find_chunk(t);
+    ColumnarChunk columns;
+    if (chunk >= index_.size() || !read_chunk(chunk, columns)) return nullptr;
+
+    auto it = std::lower_bound(columns.time.begin(), columns.time.end(), t);
+    return columns.frame(it - columns.time.begin());
+}
+
+} // namespace scrimmage
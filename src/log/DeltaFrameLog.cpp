@@ -0,0 +1,405 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/log/DeltaFrameLog.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+using std::cout;
+using std::endl;
+
+namespace io = boost::iostreams;
+namespace sp = scrimmage_proto;
+
+namespace scrimmage {
+
+namespace {
+const char magic[8] = {'S', 'C', 'R', 'D', 'L', 'T', '0', '1'};
+
+void put_varint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool get_varint(const std::string &in, size_t &offset, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < in.size(); shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(in[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Quantized values are clamped to +-max_multiple multiples of the quantum,
+// so the differences between them can't overflow. The codes just past it
+// stand for the values that can't be rounded.
+const int64_t max_multiple = int64_t(1) << 52;
+const int64_t nan_multiple = max_multiple + 1;
+const int64_t inf_multiple = max_multiple + 2;
+
+int64_t quantize(double value, double q) {
+    if (std::isnan(value)) return nan_multiple;
+    if (std::isinf(value)) return value > 0 ? inf_multiple : -inf_multiple;
+    double n = value / q;
+    if (std::abs(n) > max_multiple) return n > 0 ? max_multiple : -max_multiple;
+    return std::llround(n);
+}
+
+double dequantize(int64_t n, double q) {
+    if (n == nan_multiple) return std::numeric_limits<double>::quiet_NaN();
+    if (n == inf_multiple) return std::numeric_limits<double>::infinity();
+    if (n == -inf_multiple) return -std::numeric_limits<double>::infinity();
+    return n * q;
+}
+
+template <class T>
+void put_raw(std::string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+void write_raw(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+bool read_raw(std::ifstream &in, T &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+void get_values(const sp::Contact &c, double (&v)[DeltaFrameCodec::num_values]) {
+    const sp::State &s = c.state();
+    v[0] = s.position().x();
+    v[1] = s.position().y();
+    v[2] = s.position().z();
+    v[3] = s.velocity().x();
+    v[4] = s.velocity().y();
+    v[5] = s.velocity().z();
+    v[6] = s.orientation().x();
+    v[7] = s.orientation().y();
+    v[8] = s.orientation().z();
+    v[9] = s.orientation().w();
+}
+
+void set_values(const double (&v)[DeltaFrameCodec::num_values], sp::Contact &c) {
+    sp::State *s = c.mutable_state();
+    s->mutable_position()->set_x(v[0]);
+    s->mutable_position()->set_y(v[1]);
+    s->mutable_position()->set_z(v[2]);
+    s->mutable_velocity()->set_x(v[3]);
+    s->mutable_velocity()->set_y(v[4]);
+    s->mutable_velocity()->set_z(v[5]);
+    s->mutable_orientation()->set_x(v[6]);
+    s->mutable_orientation()->set_y(v[7]);
+    s->mutable_orientation()->set_z(v[8]);
+    s->mutable_orientation()->set_w(v[9]);
+}
+} // namespace
+
+DeltaFrameWriter::~DeltaFrameWriter() {
+    close();
+}
+
+bool DeltaFrameWriter::open(const std::string &filename, unsigned int keyframe_interval,
+                            double quantum, double quat_quantum) {
+    output_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!output_.is_open()) {
+        cout << "Failed to open file for writing: " << filename << endl;
+        return false;
+    }
+    keyframe_interval_ = keyframe_interval < 1 ? 1 : keyframe_interval;
+    quantum_ = quantum > 0 ? quantum : 0;
+    quat_quantum_ = quantum_ == 0 ? 0 : quat_quantum > 0 ? quat_quantum : quantum_;
+    num_frames_ = 0;
+    block_.clear();
+
+    output_.write(magic, sizeof(magic));
+    write_raw(output_, quantum_);
+    write_raw(output_, quat_quantum_);
+    return output_.good();
+}
+
+bool DeltaFrameWriter::write_frame(const sp::Frame &frame) {
+    if (!output_.is_open()) return false;
+
+    if (num_frames_ == 0) {
+        // keyframe
+        prev_.clear();
+        keyframe_time_ = frame.time();
+    }
+
+    put_raw(block_, frame.time());
+    put_varint(block_, frame.contact_size());
+    double v[num_values];
+    for (const sp::Contact &c : frame.contact()) {
+        const sp::ID &id = c.id();
+        put_varint(block_, zigzag(id.id()));
+
+        auto it = prev_.find(id.id());
+        bool header = it == prev_.end();
+        if (header) it = prev_.emplace(id.id(), Entry()).first;
+        Entry &e = it->second;
+        header = header || e.sub_swarm_id != id.sub_swarm_id() ||
+            e.team_id != id.team_id() || e.type != c.type() ||
+            e.active != c.active();
+
+        block_.push_back(header ? 1 : 0);
+        if (header) {
+            e.sub_swarm_id = id.sub_swarm_id();
+            e.team_id = id.team_id();
+            e.type = c.type();
+            e.active = c.active();
+            put_varint(block_, zigzag(e.sub_swarm_id));
+            put_varint(block_, zigzag(e.team_id));
+            put_varint(block_, e.type);
+            block_.push_back(e.active ? 1 : 0);
+        }
+
+        get_values(c, v);
+        for (int k = 0; k < num_values; k++) {
+            if (quantum_ == 0) {
+                uint64_t bits;
+                std::memcpy(&bits, &v[k], sizeof(bits));
+                put_varint(block_, bits ^ e.values[k]);
+                e.values[k] = bits;
+            } else {
+                double q = k < 6 ? quantum_ : quat_quantum_;
+                int64_t n = quantize(v[k], q);
+                put_varint(block_, zigzag(n - static_cast<int64_t>(e.values[k])));
+                e.values[k] = static_cast<uint64_t>(n);
+            }
+        }
+    }
+
+    if (++num_frames_ == keyframe_interval_) return write_block();
+    return true;
+}
+
+bool DeltaFrameCodec::is_delta_log(const void *data, size_t size) {
+    return size >= sizeof(magic) && std::memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+bool DeltaFrameWriter::write_block() {
+    compressed_.clear();
+    {
+        io::filtering_ostream out;
+        out.push(io::zlib_compressor(io::zlib_params(io::zlib::best_speed)));
+        out.push(io::back_inserter(compressed_));
+        out.write(block_.data(), block_.size());
+    }
+
+    write_raw(output_, static_cast<uint32_t>(block_.size()));
+    write_raw(output_, static_cast<uint32_t>(compressed_.size()));
+    write_raw(output_, static_cast<uint32_t>(num_frames_));
+    write_raw(output_, keyframe_time_);
+    output_.write(compressed_.data(), compressed_.size());
+
+    block_.clear();
+    num_frames_ = 0;
+    return output_.good();
+}
+
+bool DeltaFrameWriter::close() {
+    if (!output_.is_open()) return true;
+    bool success = num_frames_ == 0 || write_block();
+    output_.close();
+    return success;
+}
+
+DeltaFrameReader::DeltaFrameReader() : frame_(new sp::Frame()) {}
+
+DeltaFrameReader::~DeltaFrameReader() {}
+
+bool DeltaFrameReader::open(const std::string &filename) {
+    input_.close();
+    input_.clear();
+    input_.open(filename, std::ios::binary);
+    if (!input_.is_open()) {
+        cout << "Failed to open file: " << filename << endl;
+        return false;
+    }
+
+    char header[sizeof(magic)];
+    if (!input_.read(header, sizeof(header)) ||
+        std::memcmp(header, magic, sizeof(magic)) != 0 ||
+        !read_raw(input_, quantum_) || !read_raw(input_, quat_quantum_)) {
+        cout << "Not a delta encoded frame log: " << filename << endl;
+        return false;
+    }
+    first_block_ = input_.tellg();
+    rewind();
+    return true;
+}
+
+void DeltaFrameReader::rewind() {
+    input_.clear();
+    input_.seekg(first_block_);
+    frames_left_ = 0;
+    eof_ = false;
+    error_ = false;
+}
+
+bool DeltaFrameReader::read_block() {
+    uint32_t raw_size, compressed_size, num_frames;
+    double keyframe_time;
+    if (!read_raw(input_, raw_size)) {
+        eof_ = input_.eof();
+        error_ = !eof_;
+        return false;
+    }
+    if (!read_raw(input_, compressed_size) || !read_raw(input_, num_frames) ||
+        !read_raw(input_, keyframe_time)) {
+        error_ = true;
+        return false;
+    }
+
+    compressed_.resize(compressed_size);
+    if (!input_.read(&compressed_[0], compressed_size)) {
+        error_ = true;
+        return false;
+    }
+
+    block_.clear();
+    block_.reserve(raw_size);
+    try {
+        io::filtering_istream in;
+        in.push(io::zlib_decompressor());
+        in.push(io::array_source(compressed_.data(), compressed_.size()));
+        io::copy(in, io::back_inserter(block_));
+    } catch (const io::zlib_error &e) {
+        error_ = true;
+        return false;
+    }
+    if (block_.size() != raw_size) {
+        error_ = true;
+        return false;
+    }
+
+    prev_.clear();
+    offset_ = 0;
+    frames_left_ = num_frames;
+    return true;
+}
+
+bool DeltaFrameReader::next() {
+    if (error_ || eof_) return false;
+    while (frames_left_ == 0) {
+        if (!read_block()) return false;
+    }
+    if (!decode_frame()) {
+        error_ = true;
+        return false;
+    }
+    frames_left_--;
+    return true;
+}
+
+bool DeltaFrameReader::decode_frame() {
+    frame_->Clear();
+
+    double time;
+    uint64_t num_contacts;
+    if (offset_ + sizeof(time) > block_.size()) return false;
+    std::memcpy(&time, &block_[offset_], sizeof(time));
+    offset_ += sizeof(time);
+    frame_->set_time(time);
+    if (!get_varint(block_, offset_, num_contacts)) return false;
+
+    double v[num_values];
+    for (uint64_t i = 0; i < num_contacts; i++) {
+        uint64_t id, x;
+        if (!get_varint(block_, offset_, id) || offset_ >= block_.size()) return false;
+        int contact_id = static_cast<int>(unzigzag(id));
+        Entry &e = prev_[contact_id];
+
+        if (block_[offset_++] != 0) {
+            uint64_t sub_swarm_id, team_id, type;
+            if (!get_varint(block_, offset_, sub_swarm_id) ||
+                !get_varint(block_, offset_, team_id) ||
+                !get_varint(block_, offset_, type) ||
+                offset_ >= block_.size()) {
+                return false;
+            }
+            e.sub_swarm_id = static_cast<int>(unzigzag(sub_swarm_id));
+            e.team_id = static_cast<int>(unzigzag(team_id));
+            e.type = static_cast<int>(type);
+            e.active = block_[offset_++] != 0;
+        }
+
+        for (int k = 0; k < num_values; k++) {
+            if (!get_varint(block_, offset_, x)) return false;
+            if (quantum_ == 0) {
+                e.values[k] ^= x;
+                std::memcpy(&v[k], &e.values[k], sizeof(double));
+            } else {
+                e.values[k] = static_cast<uint64_t>(
+                    static_cast<int64_t>(e.values[k]) + unzigzag(x));
+                double q = k < 6 ? quantum_ : quat_quantum_;
+                v[k] = dequantize(static_cast<int64_t>(e.values[k]), q);
+            }
+        }
+
+        sp::Contact *c = frame_->add_contact();
+        set_values(v, *c);
+        c->set_type(static_cast<sp::ContactType>(e.type));
+        c->set_active(e.active);
+        sp::ID *sp_id = c->mutable_id();
+        sp_id->set_id(contact_id);
+        sp_id->set_sub_swarm_id(e.sub_swarm_id);
+        sp_id->set_team_id(e.team_id);
+    }
+    return true;
+}
+
+} // namespace scrimmage
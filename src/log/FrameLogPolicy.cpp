@@ -0,0 +1,168 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/entity/Contact.h>
+#include <scrimmage/log/FrameLogPolicy.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace scrimmage {
+
+namespace {
+// tolerance when comparing sim times, which accumulate rounding errors
+const double time_eps = 1e-9;
+} // namespace
+
+void FrameLogPolicy::set_event_window(double pre, double post) {
+    pre_ = std::max(0.0, pre);
+    post_ = std::max(0.0, post);
+}
+
+bool FrameLogPolicy::enabled() const {
+    return rate_ > 0 || dead_band_ > 0 || events_enabled_;
+}
+
+void FrameLogPolicy::add_event(double t) {
+    if (!events_enabled_) return;
+    if (!event_pending_ || t < event_time_) event_time_ = t;
+    event_pending_ = true;
+    post_end_time_ = std::max(post_end_time_, t + post_);
+}
+
+bool FrameLogPolicy::update(double t, ContactMap &contacts, bool force) {
+    stats_.frames++;
+    bool log = force || first_;
+
+    if (event_pending_) {
+        log = true;
+        for (FrameSnapshot &frame : buffered_) {
+            if (frame.time >= event_time_ - pre_ - time_eps) {
+                flushed_.push_back(std::move(frame));
+            }
+        }
+        event_pending_ = false;
+    } else if (events_enabled_ && t <= post_end_time_ + time_eps) {
+        log = true;
+    }
+
+    if (rate_ > 0) {
+        if (first_) {
+            rate_start_ = t;
+            rate_count_ = 0;
+        }
+        const double next = rate_start_ + rate_count_ / rate_;
+        if (t >= next - time_eps) {
+            log = true;
+            // the next frame after t on the grid of frames every 1 / rate
+            rate_count_ = static_cast<uint64_t>((t - rate_start_) * rate_ + time_eps) + 1;
+        }
+    }
+
+    if (!log && dead_band_ > 0 && moved(contacts)) {
+        log = true;
+    }
+
+    first_ = false;
+    if (!log) return false;
+
+    // frames skipped before a logged frame can't be logged after it
+    for (FrameSnapshot &frame : buffered_) recycle(frame);
+    buffered_.clear();
+    if (dead_band_ > 0) set_logged(contacts);
+    stats_.logged += 1 + flushed_.size();
+    return true;
+}
+
+void FrameLogPolicy::buffer_frame(double t, ContactMap &contacts) {
+    while (!buffered_.empty() && buffered_.front().time < t - pre_ - time_eps) {
+        recycle(buffered_.front());
+        buffered_.pop_front();
+    }
+
+    // Copying the contacts into a recycled snapshot doesn't allocate once
+    // the buffer has filled
+    if (spare_.empty()) {
+        buffered_.emplace_back();
+    } else {
+        buffered_.push_back(std::move(spare_.back()));
+        spare_.pop_back();
+    }
+    buffered_.back().capture(t, contacts);
+}
+
+std::vector<FrameSnapshot> FrameLogPolicy::take_buffered_frames() {
+    std::vector<FrameSnapshot> frames;
+    std::swap(frames, flushed_);
+    return frames;
+}
+
+void FrameLogPolicy::recycle_frames(std::vector<FrameSnapshot> &frames) {
+    for (FrameSnapshot &frame : frames) recycle(frame);
+    frames.clear();
+}
+
+void FrameLogPolicy::recycle(FrameSnapshot &frame) {
+    if (frame.contacts.capacity() > 0) spare_.push_back(std::move(frame));
+}
+
+bool FrameLogPolicy::moved(ContactMap &contacts) {
+    if (contacts.size() != logged_contacts_.size()) return true;
+
+    const double dead_band_sq = dead_band_ * dead_band_;
+    for (auto &kv : contacts) {
+        auto it = logged_contacts_.find(kv.first);
+        if (it == logged_contacts_.end()) return true;
+
+        Contact &c = kv.second;
+        const LoggedContact &logged = it->second;
+        if (logged.active != c.active() ||
+            logged.type != static_cast<int>(c.type()) ||
+            (c.state()->pos() - logged.pos).squaredNorm() > dead_band_sq) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FrameLogPolicy::set_logged(ContactMap &contacts) {
+    logged_contacts_.clear();
+    for (auto &kv : contacts) {
+        Contact &c = kv.second;
+        logged_contacts_[kv.first] =
+            LoggedContact{c.state()->pos(), static_cast<int>(c.type()), c.active()};
+    }
+}
+
+} // namespace scrimmage
@@ -0,0 +1,233 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/entity/Contact.h>
+#include <scrimmage/log/FrameLogger.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/network/Interface.h>
+#include <scrimmage/proto/Frame.pb.h>
+#include <scrimmage/proto/ProtoConversions.h>
+
+#include <chrono> // NOLINT
+#include <memory>
+#include <utility>
+
+namespace scrimmage {
+
+void FrameSnapshot::capture(double t, ContactMap &contact_map) {
+    time = t;
+    frame = nullptr;
+    save = true;
+    display = true;
+    contacts.resize(contact_map.size());
+    size_t i = 0;
+    for (auto &kv : contact_map) {
+        Contact &c = kv.second;
+        const ID &id = c.id();
+        const StatePtr &state = c.state();
+        ContactSnapshot &s = contacts[i++];
+        s.id = id.id();
+        s.sub_swarm_id = id.sub_swarm_id();
+        s.team_id = id.team_id();
+        s.type = static_cast<int>(c.type());
+        s.active = c.active();
+        for (int j = 0; j < 3; j++) {
+            s.pos[j] = state->pos()(j);
+            s.vel[j] = state->vel()(j);
+        }
+        s.quat[0] = state->quat().x();
+        s.quat[1] = state->quat().y();
+        s.quat[2] = state->quat().z();
+        s.quat[3] = state->quat().w();
+    }
+    contacts.resize(i);
+}
+
+std::shared_ptr<scrimmage_proto::Frame> FrameSnapshot::to_frame() const {
+    if (frame) return frame;
+
+    auto built = std::make_shared<scrimmage_proto::Frame>();
+    built->set_time(time);
+
+    for (const ContactSnapshot &s : contacts) {
+        set(built->add_contact(), ID(s.id, s.sub_swarm_id, s.team_id),
+            static_cast<Contact::Type>(s.type), s.active, s.pos, s.vel, s.quat);
+    }
+
+    return built;
+}
+
+FrameLogger::~FrameLogger() {
+    stop();
+}
+
+bool FrameLogger::parse_policy(const std::string &str, Policy &policy) {
+    if (str == "block") {
+        policy = Policy::BLOCK;
+    } else if (str == "drop") {
+        policy = Policy::DROP;
+    } else if (str == "decimate") {
+        policy = Policy::DECIMATE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void FrameLogger::start(InterfacePtr interface, size_t queue_size, Policy policy) {
+    stop();
+    interface_ = interface;
+    policy_ = policy;
+    slots_.clear();
+    slots_.resize(queue_size < 1 ? 1 : queue_size);
+    head_ = 0;
+    tail_ = 0;
+    stop_ = false;
+    interval_ = 1;
+    offered_ = 0;
+    stats_ = Stats();
+    thread_ = std::thread(&FrameLogger::worker, this);
+}
+
+void FrameLogger::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    not_empty_cv_.notify_one();
+    thread_.join();
+}
+
+FrameLogger::Snapshot *FrameLogger::next_slot() {
+    const uint64_t capacity = slots_.size();
+    uint64_t tail;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (head_ - tail_ == capacity && policy_ == Policy::BLOCK) {
+            auto start = std::chrono::steady_clock::now();
+            not_full_cv_.wait(lock, [&]() {return head_ - tail_ < capacity;});
+            stats_.wait_time += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        tail = tail_;
+    }
+
+    const uint64_t queued = head_ - tail;
+    if (policy_ == Policy::DECIMATE) {
+        if (queued == capacity) {
+            interval_ *= 2;
+        } else if (interval_ > 1 && queued <= capacity / 4) {
+            interval_ /= 2;
+        }
+        if (offered_++ % interval_ != 0) {
+            stats_.decimated++;
+            return nullptr;
+        }
+    }
+    if (queued == capacity) {
+        stats_.dropped++;
+        return nullptr;
+    }
+
+    // The slot at head_ isn't visible to the logging thread until head_ is
+    // advanced, so it is filled without holding the lock.
+    return &slots_[head_ % capacity];
+}
+
+void FrameLogger::push_slot() {
+    stats_.frames++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        head_++;
+    }
+    not_empty_cv_.notify_one();
+}
+
+void FrameLogger::log_frame(double t, ContactMap &contacts, bool save, bool display) {
+    Snapshot *slot = next_slot();
+    if (slot == nullptr) return;
+
+    slot->capture(t, contacts);
+    slot->save = save;
+    slot->display = display;
+    push_slot();
+}
+
+void FrameLogger::log_frame(std::shared_ptr<scrimmage_proto::Frame> frame) {
+    Snapshot *slot = next_slot();
+    if (slot == nullptr) return;
+
+    slot->time = frame->time();
+    slot->frame = std::move(frame);
+    slot->save = true;
+    slot->display = true;
+    push_slot();
+}
+
+void FrameLogger::log_frame(FrameSnapshot &snapshot) {
+    Snapshot *slot = next_slot();
+    if (slot == nullptr) return;
+
+    std::swap(*slot, snapshot);
+    push_slot();
+}
+
+void FrameLogger::worker() {
+    const uint64_t capacity = slots_.size();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        not_empty_cv_.wait(lock, [&]() {return stop_ || head_ != tail_;});
+        if (head_ == tail_) break; // stopped and every frame was sent
+
+        Snapshot &snapshot = slots_[tail_ % capacity];
+        lock.unlock();
+        send(snapshot);
+        snapshot.frame = nullptr;
+        lock.lock();
+
+        tail_++;
+        not_full_cv_.notify_one();
+    }
+}
+
+void FrameLogger::send(const Snapshot &snapshot) {
+    std::shared_ptr<scrimmage_proto::Frame> frame = snapshot.to_frame();
+    if (snapshot.save) {
+        interface_->save_frame(frame);
+    }
+    if (snapshot.display && !interface_->display_frame(frame)) {
+        stats_.failed++;
+    }
+}
+
+} // namespace scrimmage
@@ -0,0 +1,181 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <scrimmage/log/FrameReader.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+namespace scrimmage {
+
+FrameReader::FrameReader() : frame_(new scrimmage_proto::Frame()) {}
+
+FrameReader::~FrameReader() {
+    close();
+}
+
+bool FrameReader::open(const std::string &filename) {
+    close();
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ == -1) {
+        cout << "Failed to open file: " << filename << endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) == -1) {
+        cout << "Failed to stat file: " << filename << endl;
+        close();
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) return true;
+
+    void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+        cout << "Failed to memory map file: " << filename << endl;
+        size_ = 0;
+        close();
+        return false;
+    }
+    data_ = static_cast<const uint8_t *>(data);
+
+    if (DeltaFrameCodec::is_delta_log(data_, size_)) {
+        size_t size = size_;
+        close();
+        size_ = size;
+        delta_.reset(new DeltaFrameReader());
+        if (!delta_->open(filename)) {
+            delta_.reset();
+            return false;
+        }
+        return true;
+    }
+    madvise(data, size_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void FrameReader::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t *>(data_), size_);
+        data_ = nullptr;
+    }
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+    offset_ = 0;
+    error_ = false;
+    delta_.reset();
+}
+
+void FrameReader::seek(size_t offset) {
+    if (delta_) {
+        delta_->rewind();
+        offset_ = 0;
+        while (offset_ < offset && next()) {}
+        return;
+    }
+    offset_ = offset < size_ ? offset : size_;
+    error_ = false;
+}
+
+bool FrameReader::read_size(uint32_t &size) {
+    // frames are prefixed by their size as a varint (see Log::writeDelimitedTo)
+    size = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (offset_ >= size_) {
+            error_ = true;
+            return false;
+        }
+        uint8_t byte = data_[offset_++];
+        size |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            if (size > size_ - offset_) {
+                error_ = true;
+                return false;
+            }
+            return true;
+        }
+    }
+    error_ = true;
+    return false;
+}
+
+bool FrameReader::next() {
+    if (delta_) {
+        if (!delta_->next()) return false;
+        offset_++;
+        return true;
+    }
+    if (error_ || offset_ >= size_) return false;
+
+    size_t start = offset_;
+    uint32_t size;
+    if (!read_size(size)) {
+        offset_ = start;
+        return false;
+    }
+    if (!frame_->ParseFromArray(data_ + offset_, static_cast<int>(size))) {
+        error_ = true;
+        offset_ = start;
+        return false;
+    }
+    offset_ += size;
+    return true;
+}
+
+bool FrameReader::skip() {
+    // the frames of a delta log depend on the frames before them
+    if (delta_) return next();
+    if (error_ || offset_ >= size_) return false;
+
+    size_t start = offset_;
+    uint32_t size;
+    if (!read_size(size)) {
+        offset_ = start;
+        return false;
+    }
+    offset_ += size;
+    return true;
+}
+
+} // namespace scrimmage
@@ -42,6 +42,8 @@
 #include <scrimmage/proto/Shape.pb.h>
 #include <scrimmage/proto/Visual.pb.h>
 #include <scrimmage/math/State.h>
+#include <scrimmage/log/ColumnarLog.h>
+#include <scrimmage/log/DeltaFrameLog.h>
 #include <scrimmage/log/Log.h>
 #include <scrimmage/proto/ProtoConversions.h>
 #include <scrimmage/plugin_manager/Plugin.h>
@@ -95,6 +97,8 @@ bool Log::init(const std::string &dir, Log::Mode mode) {
     utm_terrain_name_ = log_dir_ + "/" + utm_terrain_name_;
     contact_visual_name_ = log_dir_ + "/" + contact_visual_name_;
     msgs_name_ = log_dir_ + "/" + msgs_name_;
+    columnar_frames_name_ = log_dir_ + "/" + columnar_frames_name_;
+    compressed_frames_name_ = log_dir_ + "/" + compressed_frames_name_;
 
     if (mode_ == WRITE) {
         if (open_file(frames_name_, frames_fd_)) {
@@ -134,7 +138,45 @@ bool Log::write_ascii(const std::string &str) {
 }
 
 bool Log::save_frame(const std::shared_ptr<scrimmage_proto::Frame> &frame) {
-    return writeDelimitedTo(*frame, frames_output_);
+    // frames.bin isn't written when the frames are compressed
+    bool success = !frames_output_ || writeDelimitedTo(*frame, frames_output_);
+    if (columnar_frames_output_ && mode_ == WRITE && enable_log_) {
+        success &= columnar_frames_output_->write_frame(*frame);
+    }
+    if (compressed_frames_output_ && mode_ == WRITE && enable_log_) {
+        success &= compressed_frames_output_->write_frame(*frame);
+    }
+    return success;
+}
+
+bool Log::enable_columnar_frames(double chunk_duration) {
+    if (mode_ != WRITE || !enable_log_) return false;
+    columnar_frames_output_ = std::make_shared<ColumnarLogWriter>();
+    if (!columnar_frames_output_->open(columnar_frames_name_, chunk_duration)) {
+        columnar_frames_output_.reset();
+        return false;
+    }
+    return true;
+}
+
+bool Log::enable_compressed_frames(unsigned int keyframe_interval,
+                                   double quantum, double quat_quantum) {
+    if (mode_ != WRITE || !enable_log_) return false;
+    compressed_frames_output_ = std::make_shared<DeltaFrameWriter>();
+    if (!compressed_frames_output_->open(compressed_frames_name_, keyframe_interval,
+                                         quantum, quat_quantum)) {
+        compressed_frames_output_.reset();
+        return false;
+    }
+
+    // frames.delta replaces the (still empty) frames.bin
+    if (frames_output_) {
+        frames_output_.reset();
+        ::close(frames_fd_);
+        frames_fd_ = -1;
+        fs::remove(fs::path(frames_name_));
+    }
+    return true;
 }
 
 bool Log::save_shapes(const scrimmage_proto::Shapes &shapes) {
@@ -151,6 +193,10 @@ bool Log::save_contact_visual(const std::shared_ptr<scrimmage_proto::ContactVisu
 
 std::string Log::frames_filename() { return frames_name_; }
 
+std::string Log::columnar_frames_filename() { return columnar_frames_name_; }
+
+std::string Log::compressed_frames_filename() { return compressed_frames_name_; }
+
 std::string Log::shapes_filename() { return shapes_name_; }
 
 std::string Log::utm_terrain_filename() { return utm_terrain_name_; }
@@ -167,10 +213,12 @@ bool Log::parse(std::string dir) {
         return false;
     }
 
-    if (!fs::exists(fs::path(frames_name_))) {
-        cout << "Frames file doesn't exist: " << frames_name_ << endl;
-    } else {
+    if (fs::exists(fs::path(frames_name_))) {
         parse(frames_name_, FRAMES);
+    } else if (fs::exists(fs::path(compressed_frames_name_))) {
+        parse_compressed_frames(compressed_frames_name_);
+    } else {
+        cout << "Frames file doesn't exist: " << frames_name_ << endl;
     }
 
     if (!fs::exists(fs::path(shapes_name_))) {
@@ -246,6 +294,24 @@ bool Log::parse_frames(std::string filename,
     return true;
 }
 
+bool Log::parse_compressed_frames(std::string filename) {
+    frames_.clear();
+    scrimmage_frames_.clear();
+    DeltaFrameReader reader;
+    if (!reader.open(filename)) return false;
+
+    while (reader.next()) {
+        auto frame = std::make_shared<scrimmage_proto::Frame>(reader.frame());
+        frames_.push_back(frame);
+        scrimmage_frames_.push_back(proto_2_frame(*frame));
+    }
+
+    if (!reader.clean_eof()) {
+        cout << "Frames - WARNING: Clean end-of-file not detected." << endl;
+    }
+    return true;
+}
+
 bool Log::parse_shapes(std::string filename,
                       ZeroCopyInputStreamPtr input) {
     shapes_.clear();
@@ -372,6 +438,15 @@ bool Log::close_log() {
         ascii_output_.close();
     }
 
+    if (columnar_frames_output_) {
+        columnar_frames_output_->close();
+        columnar_frames_output_.reset();
+    }
+    if (compressed_frames_output_) {
+        compressed_frames_output_->close();
+        compressed_frames_output_.reset();
+    }
+
     google::protobuf::ShutdownProtobufLibrary();
     frames_output_.reset();
     shapes_output_.reset();
@@ -32,6 +32,7 @@
 
 #include <scrimmage/common/Utilities.h>
 #include <scrimmage/math/State.h>
+#include <scrimmage/math/StateStore.h>
 #include <scrimmage/math/Angles.h>
 
 #include <iostream>
@@ -39,36 +40,68 @@
 
 namespace scrimmage {
 
-State::State() : pos_(0, 0, 0), vel_(0, 0, 0), ang_vel_(0, 0, 0) {}
+State::State() : local_pos_(0, 0, 0), local_vel_(0, 0, 0), local_ang_vel_(0, 0, 0) {
+    use_local_storage();
+}
 
 State::State(Eigen::Vector3d _pos, Eigen::Vector3d _vel,
              Eigen::Vector3d _ang_vel, Quaternion _quat) :
-    pos_(_pos), vel_(_vel), ang_vel_(_ang_vel), quat_(_quat) {}
+    local_pos_(_pos), local_vel_(_vel), local_ang_vel_(_ang_vel),
+    local_quat_(_quat) {
+    use_local_storage();
+}
+
+State::State(const State &other) :
+    output_precision(other.output_precision),
+    local_pos_(*other.pos_), local_vel_(*other.vel_),
+    local_ang_vel_(*other.ang_vel_), local_quat_(*other.quat_) {
+    use_local_storage();
+}
+
+State &State::operator=(const State &other) {
+    output_precision = other.output_precision;
+    *pos_ = *other.pos_;
+    *vel_ = *other.vel_;
+    *ang_vel_ = *other.ang_vel_;
+    *quat_ = *other.quat_;
+    return *this;
+}
 
-State::~State() {}
+State::~State() {
+    if (store_) {
+        store_->release(slot_);
+    }
+}
+
+void State::use_local_storage() {
+    pos_ = &local_pos_;
+    vel_ = &local_vel_;
+    ang_vel_ = &local_ang_vel_;
+    quat_ = &local_quat_;
+}
 
-Eigen::Vector3d &State::pos() {return pos_;}
+Eigen::Vector3d &State::pos() {return *pos_;}
 
-Eigen::Vector3d &State::vel() {return vel_;}
-Eigen::Vector3d &State::ang_vel() {return ang_vel_;}
+Eigen::Vector3d &State::vel() {return *vel_;}
+Eigen::Vector3d &State::ang_vel() {return *ang_vel_;}
 
-Quaternion &State::quat() {return quat_;}
+Quaternion &State::quat() {return *quat_;}
 
-const Eigen::Vector3d &State::pos_const() const {return pos_;}
+const Eigen::Vector3d &State::pos_const() const {return *pos_;}
 
-const Eigen::Vector3d &State::vel_const() const {return vel_;}
+const Eigen::Vector3d &State::vel_const() const {return *vel_;}
 
-const Eigen::Vector3d &State::ang_vel_const() const {return ang_vel_;}
+const Eigen::Vector3d &State::ang_vel_const() const {return *ang_vel_;}
 
-const Quaternion &State::quat_const() const {return quat_;}
+const Quaternion &State::quat_const() const {return *quat_;}
 
-void State::set_pos(const Eigen::Vector3d &pos) {pos_ = pos;}
+void State::set_pos(const Eigen::Vector3d &pos) {*pos_ = pos;}
 
-void State::set_vel(const Eigen::Vector3d &vel) {vel_ = vel;}
+void State::set_vel(const Eigen::Vector3d &vel) {*vel_ = vel;}
 
-void State::set_ang_vel(const Eigen::Vector3d &ang_vel) {ang_vel_ = ang_vel;}
+void State::set_ang_vel(const Eigen::Vector3d &ang_vel) {*ang_vel_ = ang_vel;}
 
-void State::set_quat(const Quaternion &quat) {quat_ = quat;}
+void State::set_quat(const Quaternion &quat) {*quat_ = quat;}
 
 bool State::InFieldOfView(State &other, double fov_width, double fov_height) const {
     Eigen::Vector3d rel_pos = this->rel_pos_local_frame(other.pos());
@@ -79,34 +112,34 @@ bool State::InFieldOfView(State &other, double fov_width, double fov_height) con
 }
 
 Eigen::Vector3d State::rel_pos_local_frame(Eigen::Vector3d &other) const {
-    return quat_.rotate_reverse(other - pos_);
+    return quat_->rotate_reverse(other - *pos_);
 }
 
 Eigen::Vector3d State::pos_offset(double distance, bool offset_with_velocity) const {
     if (offset_with_velocity) {
-        return pos_ + vel_.normalized() * distance;
+        return *pos_ + vel_->normalized() * distance;
     } else {
-        return pos_ + orient_global_frame() * distance;
+        return *pos_ + orient_global_frame() * distance;
     }
 }
 
 Eigen::Vector3d State::orient_global_frame() const {
-    return quat_.rotate(Eigen::Vector3d::UnitX());
+    return quat_->rotate(Eigen::Vector3d::UnitX());
 }
 
 double State::rel_az(const Eigen::Vector3d &other) const {
-    Eigen::Vector3d diff = other - pos_;
+    Eigen::Vector3d diff = other - *pos_;
     double az = atan2(diff(1), diff(0));
-    return Angles::angle_diff_rad(az, quat_.yaw());
+    return Angles::angle_diff_rad(az, quat_->yaw());
 }
 
 Eigen::Matrix4d State::tf_matrix(bool enable_translate) {
     Eigen::Matrix4d m;
 
-    double d = pos_(2); // translate by di along zi-axis
-    double theta = quat_.yaw(); // rotate cw by theta about zi-axis
-    double a = pos_(0); // translate by a_i_1 along the x_i_1 axis
-    double alpha = quat_.roll(); // rotate cw by alpha_i_1 about x_i_1 axis
+    double d = (*pos_)(2); // translate by di along zi-axis
+    double theta = quat_->yaw(); // rotate cw by theta about zi-axis
+    double a = (*pos_)(0); // translate by a_i_1 along the x_i_1 axis
+    double alpha = quat_->roll(); // rotate cw by alpha_i_1 about x_i_1 axis
 
     if (!enable_translate) {
         d = 0;
@@ -129,9 +162,9 @@ Eigen::Matrix4d State::tf_matrix(bool enable_translate) {
 std::ostream& operator<<(std::ostream& os, const State& s) {
     const Quaternion &q = s.quat_const();
 
-    os << "(" << eigen_str(s.pos_, s.output_precision)
-        << "), (" << eigen_str(s.vel_, s.output_precision)
-        << "), (" << eigen_str(s.ang_vel_, s.output_precision)
+    os << "(" << eigen_str(s.pos_const(), s.output_precision)
+        << "), (" << eigen_str(s.vel_const(), s.output_precision)
+        << "), (" << eigen_str(s.ang_vel_const(), s.output_precision)
         << "), ("
         << std::setprecision(s.output_precision) << q.roll() << ", "
         << std::setprecision(s.output_precision) << q.pitch() << ", "
@@ -0,0 +1,94 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/math/State.h>
+#include <scrimmage/math/StateStore.h>
+
+namespace scrimmage {
+
+void StateStore::add(State &state, const ID &id) {
+    if (state.store_) {
+        state.store_->remove(state);
+    }
+
+    int slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_slots_.empty()) {
+            slot = num_slots_++;
+            if (offset(slot) == 0) {
+                blocks_.push_back(std::make_unique<Block>());
+            }
+        } else {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        }
+    }
+
+    Block &b = block(slot);
+    const int i = offset(slot);
+    b.pos[i] = state.local_pos_;
+    b.vel[i] = state.local_vel_;
+    b.ang_vel[i] = state.local_ang_vel_;
+    b.quat[i] = state.local_quat_;
+    b.id[i] = id;
+    b.active[i] = true;
+
+    state.pos_ = &b.pos[i];
+    state.vel_ = &b.vel[i];
+    state.ang_vel_ = &b.ang_vel[i];
+    state.quat_ = &b.quat[i];
+    state.store_ = shared_from_this();
+    state.slot_ = slot;
+}
+
+void StateStore::remove(State &state) {
+    if (state.store_.get() != this) return;
+
+    state.local_pos_ = *state.pos_;
+    state.local_vel_ = *state.vel_;
+    state.local_ang_vel_ = *state.ang_vel_;
+    state.local_quat_ = *state.quat_;
+    state.use_local_storage();
+
+    release(state.slot_);
+    state.slot_ = -1;
+    state.store_ = nullptr;
+}
+
+void StateStore::release(int slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    block(slot).active[offset(slot)] = false;
+    free_slots_.push_back(slot);
+}
+
+} // namespace scrimmage
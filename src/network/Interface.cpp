@@ -90,8 +90,15 @@ bool Interface::init_network(Interface::Mode_t mode, const std::string &ip, int
 }
 
 bool Interface::send_frame(std::shared_ptr<scrimmage_proto::Frame> &frame) {
+    save_frame(frame);
+    return display_frame(frame);
+}
+
+void Interface::save_frame(std::shared_ptr<scrimmage_proto::Frame> &frame) {
     log_->save_frame(frame);
+}
 
+bool Interface::display_frame(std::shared_ptr<scrimmage_proto::Frame> &frame) {
     if (mode_ == shared) {
         push_frame(frame);
     } else if (mode_ == client) {
@@ -41,6 +41,8 @@
 #include <scrimmage/proto/Shape.pb.h>
 #include <scrimmage/proto/ProtoConversions.h>
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 REGISTER_PLUGIN(scrimmage::Autonomy, scrimmage::autonomy::Boids, Boids_plugin)
@@ -63,6 +65,7 @@ void Boids::init(std::map<std::string, std::string> &params) {
     fov_el_ = Angles::deg2rad(get("fov_el", params, 90));
     fov_az_ = Angles::deg2rad(get("fov_az", params, 90));
     comms_range_ = get("comms_range", params, 1000);
+    comms_radius_id_ = rtree_->register_neighbor_radius(comms_range_);
 
     sphere_of_influence_ = get<double>("sphere_of_influence", params, 10);
     minimum_team_range_ = get<double>("minimum_team_range", params, 5);
@@ -96,26 +99,23 @@ void Boids::init(std::map<std::string, std::string> &params) {
 }
 
 bool Boids::step_autonomy(double t, double dt) {
-    // Find neighbors that are within field-of-view and within comms range
-    std::vector<ID> rtree_neighbors;
-    rtree_->neighbors_in_range(state_->pos_const(), rtree_neighbors, comms_range_);
-
-    // Remove neighbors that are not within field of view
-    for (auto it = rtree_neighbors.begin(); it != rtree_neighbors.end();
-         /* no inc */) {
-
-        // Ignore own position / id
-        if (it->id() == parent_->id().id()) {
-            it = rtree_neighbors.erase(it);
-        } else if (state_->InFieldOfView(*(*contacts_)[it->id()].state(), fov_az_, fov_el_)) {
-            // The neighbor is "in front"
-            ++it;
-        } else {
-            // The neighbor is "behind." Remove it.
-            it = rtree_neighbors.erase(it);
-        }
+    // Find neighbors that are within field-of-view and within comms range,
+    // ignoring own position / id
+    NeighborList list;
+    if (rtree_->neighbor_list(comms_radius_id_, parent_->id().id(), list)) {
+        neighbors_.assign(list.begin(), list.end());
+    } else {
+        rtree_->neighbors_in_range(state_->pos_const(), neighbors_, comms_range_,
+                                   parent_->id().id());
     }
 
+    // Remove neighbors that are not within field of view (i.e., "behind")
+    auto behind = [&](const Neighbor &n) {
+        return !state_->InFieldOfView(*(*contacts_)[n.id.id()].state(), fov_az_, fov_el_);
+    };
+    neighbors_.erase(std::remove_if(neighbors_.begin(), neighbors_.end(), behind),
+                     neighbors_.end());
+
     // move-to-goal behavior
     Eigen::Vector3d v_goal = (goal_ - state_->pos()).normalized();
 
@@ -131,14 +131,14 @@ bool Boids::step_autonomy(double t, double dt) {
     std::vector<Eigen::Vector3d> O_team_vecs;
     std::vector<Eigen::Vector3d> O_nonteam_vecs;
 
-    for (ID id : rtree_neighbors) {
-        bool is_team = (id.team_id() == parent_->id().team_id());
+    for (const Neighbor &n : neighbors_) {
+        bool is_team = (n.id.team_id() == parent_->id().team_id());
 
-        StatePtr other_state = (*contacts_)[id.id()].state();
+        StatePtr other_state = (*contacts_)[n.id.id()].state();
 
         // Calculate vector pointing from own position to other
         Eigen::Vector3d diff = other_state->pos() - state_->pos();
-        double dist = diff.norm();
+        double dist = std::sqrt(n.dist_sq);
 
         // Calculate magnitude of repulsion vector
         double min_range = is_team ? minimum_team_range_ : minimum_nonteam_range_;
@@ -169,10 +169,10 @@ bool Boids::step_autonomy(double t, double dt) {
     }
 
     Eigen::Vector3d align_vec(0, 0, 0);
-    if (rtree_neighbors.size() > 0) {
-        centroid = centroid / static_cast<double>(rtree_neighbors.size());
-        align = align / static_cast<double>(rtree_neighbors.size());
-        heading /= static_cast<double>(rtree_neighbors.size());
+    if (neighbors_.size() > 0) {
+        centroid = centroid / static_cast<double>(neighbors_.size());
+        align = align / static_cast<double>(neighbors_.size());
+        heading /= static_cast<double>(neighbors_.size());
         align_vec << cos(heading), sin(heading), 0;
     }
 
@@ -221,7 +221,7 @@ bool Boids::step_autonomy(double t, double dt) {
     // Scale velocity to max speed:
     Eigen::Vector3d vel_result = v_sum * max_speed_;
 
-    if (rtree_neighbors.size() > 0) {
+    if (neighbors_.size() > 0) {
 
         velocity_controller(vel_result);
 
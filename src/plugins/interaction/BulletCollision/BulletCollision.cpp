@@ -215,7 +215,8 @@ bool BulletCollision::step_entity_interaction(std::list<sc::EntityPtr> &ents,
 
         // For each ray sensor on a single entity
         for (auto kv2 : kv.second) {
-            auto msg = std::make_shared<sc::Message<RayTrace::PointCloud>>();
+            auto &pub = pcl_pubs_[kv.first][kv2.first];
+            auto msg = pub->make_msg<RayTrace::PointCloud>();
             msg->data.max_range = kv2.second.max_range;
             msg->data.min_range = kv2.second.min_range;
             msg->data.num_rays_vert = kv2.second.num_rays_vert;
@@ -284,7 +285,7 @@ bool BulletCollision::step_entity_interaction(std::list<sc::EntityPtr> &ents,
                     }
                 }
             }
-            pcl_pubs_[kv.first][kv2.first]->publish(msg);
+            pub->publish(msg);
         }
     }
 
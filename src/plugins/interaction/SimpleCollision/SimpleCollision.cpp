@@ -42,6 +42,7 @@
 
 #include <scrimmage/plugins/interaction/SimpleCollision/SimpleCollision.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 
@@ -68,6 +69,18 @@ bool SimpleCollision::init(std::map<std::string, std::string> &mission_params,
 
     init_alt_deconflict_ = sc::get<bool>("init_alt_deconflict", plugin_params, false);
 
+    // cells as wide as the collision range means each query only visits the
+    // neighboring cells
+    if (collision_range_ > 0) {
+        hash_ = std::make_unique<sc::SpatialHash>(collision_range_);
+    }
+    int num_threads = sc::get<int>("num_threads", plugin_params, 1);
+    if (num_threads > 1) {
+        scheduler_.start(num_threads);
+    }
+    thread_pairs_.resize(std::max(1, scheduler_.num_threads()));
+    thread_neighbors_.resize(thread_pairs_.size());
+
     // Setup publishers
     team_collision_pub_ = advertise("GlobalNetwork", "TeamCollision");
     non_team_collision_pub_ = advertise("GlobalNetwork", "NonTeamCollision");
@@ -82,43 +95,78 @@ bool SimpleCollision::step_entity_interaction(std::list<sc::EntityPtr> &ents,
         return true;
     }
 
-    // Account for entities "colliding"
-    for (sc::EntityPtr ent1 : ents) {
-        Eigen::Vector3d p1 = ent1->state()->pos();
-        for (sc::EntityPtr ent2 : ents) {
-            // ignore distance between itself
-            if (ent1->id().id() == ent2->id().id()) continue;
-
-            // ignore collisions that have already occurred this time-step
-            if (!ent1->is_alive() || !ent2->is_alive()) continue;
-
-            Eigen::Vector3d p2 = ent2->state()->pos();
-
-            double dist = (p1 - p2).norm();
-            if (dist < collision_range_) {
-                if (enable_team_collisions_ &&
-                    ent1->id().team_id() == ent2->id().team_id()) {
-
-                    ent1->collision();
-                    ent2->collision();
-
-                    auto msg = std::make_shared<sc::Message<sm::TeamCollision>>();
-                    msg->data.set_entity_id_1(ent1->id().id());
-                    msg->data.set_entity_id_2(ent2->id().id());
-                    team_collision_pub_->publish(msg);
-
-                } else if (enable_non_team_collisions_ &&
-                           ent1->id().team_id() != ent2->id().team_id()) {
-                    ent1->collision();
-                    ent2->collision();
-
-                    auto msg = std::make_shared<sc::Message<sm::NonTeamCollision>>();
-                    msg->data.set_entity_id_1(ent1->id().id());
-                    msg->data.set_entity_id_2(ent2->id().id());
-                    non_team_collision_pub_->publish(msg);
+    if (hash_ == nullptr) {
+        return true;
+    }
+
+    // Broadphase: find each pair of entities that are within the collision
+    // range once, with the lower index first
+    ents_.clear();
+    hash_->clear();
+    for (sc::EntityPtr &ent : ents) {
+        if (ent->is_alive()) {
+            hash_->add(ent->state()->pos(),
+                       sc::ID(static_cast<int>(ents_.size()), 0, ent->id().team_id()));
+            ents_.push_back(ent.get());
+        }
+    }
+
+    for (auto &pairs : thread_pairs_) pairs.clear();
+    auto find_pairs = [&](size_t begin, size_t end, int thread_id) {
+        auto &pairs = thread_pairs_[thread_id];
+        auto &neighbors = thread_neighbors_[thread_id];
+        for (size_t i = begin; i < end; i++) {
+            hash_->neighbors_in_range(ents_[i]->state()->pos(), neighbors,
+                                      collision_range_, static_cast<int>(i));
+            for (const sc::Neighbor &n : neighbors) {
+                if (static_cast<size_t>(n.id.id()) > i) {
+                    pairs.emplace_back(i, n.id.id());
                 }
             }
         }
+        return true;
+    };
+    scheduler_.run("broadphase", ents_.size(), find_pairs);
+
+    // Handle the pairs in the same order as a double loop over ents would
+    pairs_.clear();
+    for (auto &pairs : thread_pairs_) {
+        pairs_.insert(pairs_.end(), pairs.begin(), pairs.end());
+    }
+    std::sort(pairs_.begin(), pairs_.end());
+
+    // Account for entities "colliding"
+    for (auto &pair : pairs_) {
+        sc::Entity *ent1 = ents_[pair.first];
+        sc::Entity *ent2 = ents_[pair.second];
+
+        // ignore collisions that have already occurred this time-step
+        if (!ent1->is_alive() || !ent2->is_alive()) continue;
+
+        double dist = (ent1->state()->pos() - ent2->state()->pos()).norm();
+        if (dist < collision_range_) {
+            if (enable_team_collisions_ &&
+                ent1->id().team_id() == ent2->id().team_id()) {
+
+                ent1->collision();
+                ent2->collision();
+
+                auto msg = team_collision_pub_->make_msg<sm::TeamCollision>();
+                msg->data.set_entity_id_1(ent1->id().id());
+                msg->data.set_entity_id_2(ent2->id().id());
+                team_collision_pub_->publish(msg);
+
+            } else if (enable_non_team_collisions_ &&
+                       ent1->id().team_id() != ent2->id().team_id()) {
+                ent1->collision();
+                ent2->collision();
+
+                auto msg = non_team_collision_pub_->make_msg<sm::NonTeamCollision>();
+                msg->data.set_entity_id_1(ent1->id().id());
+                msg->data.set_entity_id_2(ent2->id().id());
+                non_team_collision_pub_->publish(msg);
+            }
+        }
     }
     return true;
 }
@@ -46,6 +46,8 @@
 
 #include <scrimmage/parse/MissionParse.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <limits>
 
@@ -66,6 +68,14 @@ CPA::CPA() {
 }
 
 void CPA::init(std::map<std::string, std::string> &params) {
+    continuous_ = sc::get<bool>("continuous", params, true);
+
+    hash_ = std::make_unique<SpatialHash>();
+    int num_threads = sc::get<int>("num_threads", params, 1);
+    if (num_threads > 1) {
+        scheduler_.start(num_threads);
+    }
+    thread_neighbors_.resize(std::max(1, scheduler_.num_threads()));
 }
 
 bool CPA::step_metrics(double t, double dt) {
@@ -83,22 +93,106 @@ bool CPA::step_metrics(double t, double dt) {
         initialized_ = true;
     }
 
+    // Entities that were removed from the simulation are still in the map,
+    // but their state has been released
+    ids_.clear();
     for (auto &kv : *id_to_ent_map_) {
-        for (auto &kv2 : *id_to_ent_map_) {
-            if (kv != kv2) {
-                double cur_distance = (kv.second->state()->pos() -
-                        kv2.second->state()->pos()).norm();
-                if (cur_distance < cpa_map_[kv.first].distance()) {
-                    cpa_map_[kv.first].set_distance(cur_distance);
-                    cpa_map_[kv.first].set_closest_entity(kv2.first);
-                    cpa_map_[kv.first].set_time(t);
-                }
-            }
+        if (kv.second->state() != nullptr) {
+            ids_.push_back(kv.first);
         }
     }
+    std::sort(ids_.begin(), ids_.end());
+
+    const size_t n = ids_.size();
+    pos_.resize(n);
+    prev_pos_.resize(n);
+    data_.resize(n);
+    hash_->clear();
+    max_displacement_ = 0;
+    for (size_t i = 0; i < n; i++) {
+        pos_[i] = id_to_ent_map_->at(ids_[i])->state()->pos();
+        auto it = last_pos_.find(ids_[i]);
+        prev_pos_[i] = (continuous_ && it != last_pos_.end()) ? it->second : pos_[i];
+        max_displacement_ = std::max(max_displacement_, (pos_[i] - prev_pos_[i]).norm());
+        data_[i] = &cpa_map_[ids_[i]];
+        hash_->add(pos_[i], ID(static_cast<int>(i), 0, 0));
+    }
+
+    if (n > 1) {
+        scheduler_.run("cpa", n, [&](size_t begin, size_t end, int thread_id) {
+            update_cpa(begin, end, thread_id, t);
+            return true;
+        });
+    }
+
+    last_pos_.clear();
+    for (size_t i = 0; i < n; i++) {
+        last_pos_[ids_[i]] = pos_[i];
+    }
+    last_t_ = t;
     return true;
 }
 
+void CPA::update_cpa(size_t begin, size_t end, int thread_id, double t) {
+    std::vector<Neighbor> &neighbors = thread_neighbors_[thread_id];
+    for (size_t i = begin; i < end; i++) {
+        CPAData &data = *data_[i];
+        const int self = static_cast<int>(i);
+
+        // The separation at the end of the step bounds the CPA, so use the
+        // nearest entity to bound the search until a CPA has been found
+        double bound = data.distance();
+        if (std::isinf(bound)) {
+            hash_->nearest_n_neighbors(pos_[i], neighbors, 1, self);
+            if (neighbors.empty()) continue;
+            bound = std::sqrt(neighbors.front().dist_sq);
+        }
+
+        // During the step, the separation can't be less than the separation
+        // at the end minus how far the two entities moved. The radius is
+        // padded so that the nearest entity found above isn't lost to
+        // rounding.
+        const double displacement = (pos_[i] - prev_pos_[i]).norm();
+        const double radius = (bound + displacement + max_displacement_) * (1 + 1e-9);
+        hash_->neighbors_in_range(pos_[i], neighbors, radius, self);
+
+        // The neighbors come in spatial hash order, so ties are broken by id
+        // to keep the entity with the lowest id, like a loop over the
+        // entities in id order would. The CPA of an earlier step is only
+        // replaced by a strictly closer approach.
+        double best_distance = std::numeric_limits<double>::infinity();
+        size_t best = 0;
+        double best_s = 1;
+        for (const Neighbor &n : neighbors) {
+            const size_t j = n.id.id();
+            const Eigen::Vector3d r0 = prev_pos_[i] - prev_pos_[j];
+            const Eigen::Vector3d r1 = pos_[i] - pos_[j];
+
+            // closest point on the straight line from r0 to r1
+            const Eigen::Vector3d dr = r1 - r0;
+            const double dr_sq = dr.squaredNorm();
+            double s = 1;
+            if (dr_sq > 0) {
+                s = std::min(1.0, std::max(0.0, -r0.dot(dr) / dr_sq));
+            }
+
+            const double distance = s == 1 ? r1.norm() : (r0 + s * dr).norm();
+            if (distance < best_distance ||
+                (distance == best_distance && j < best)) {
+                best_distance = distance;
+                best = j;
+                best_s = s;
+            }
+        }
+
+        if (best_distance < data.distance()) {
+            data.set_distance(best_distance);
+            data.set_closest_entity(ids_[best]);
+            data.set_time(best_s == 1 ? t : last_t_ + best_s * (t - last_t_));
+        }
+    }
+}
+
 void CPA::calc_team_scores() {
     for (auto &kv: cpa_map_) {
         csv_.append(scrimmage::CSV::Pairs{
@@ -0,0 +1,170 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/plugins/network/LinkNetwork/LinkNetwork.h>
+
+#include <scrimmage/common/ID.h>
+#include <scrimmage/common/Time.h>
+#include <scrimmage/common/Random.h>
+#include <scrimmage/entity/Entity.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/parse/ParseUtils.h>
+#include <scrimmage/plugin_manager/RegisterPlugin.h>
+#include <scrimmage/pubsub/NetworkDevice.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+REGISTER_PLUGIN(scrimmage::Network,
+                scrimmage::network::LinkNetwork,
+                LinkNetwork_plugin)
+
+namespace sc = scrimmage;
+
+namespace scrimmage {
+namespace network {
+
+namespace {
+bool position(const sc::PluginPtr &plugin, Eigen::Vector3d &pos) {
+    const sc::EntityPtr &ent = plugin->parent();
+    if (ent == nullptr || ent->state() == nullptr) return false;
+    pos = ent->state()->pos();
+    return true;
+}
+} // namespace
+
+bool LinkNetwork::init(std::map<std::string, std::string> &mission_params,
+                       std::map<std::string, std::string> &plugin_params) {
+    network_init(mission_params, plugin_params);
+
+    range_ = sc::get<double>("range", plugin_params, range_);
+    prob_transmit_ = sc::get<double>("prob_transmit", plugin_params, prob_transmit_);
+    latency_ = sc::get<double>("latency", plugin_params, latency_);
+    propagation_speed_ = sc::get<double>("propagation_speed", plugin_params,
+                                         propagation_speed_);
+    bandwidth_ = sc::get<double>("bandwidth", plugin_params, bandwidth_);
+    msg_bytes_ = sc::get<double>("msg_bytes", plugin_params, msg_bytes_);
+    max_backlog_ = sc::get<double>("max_backlog", plugin_params, max_backlog_);
+    return true;
+}
+
+void LinkNetwork::routed() {
+    // Deliver the messages that have arrived by now, in arrival order. They
+    // are counted as received on this step, not the step they were sent.
+    const double t = time_->t() + 1e-9;
+    while (!in_flight_.empty() && in_flight_.front().time <= t) {
+        std::pop_heap(in_flight_.begin(), in_flight_.end(), std::greater<InFlight>());
+        InFlight &arrived = in_flight_.back();
+        arrived.sub->add_msg(std::move(arrived.msg));
+        delivered(arrived.sub);
+        in_flight_.pop_back();
+    }
+}
+
+bool LinkNetwork::is_reachable(const scrimmage::PluginPtr &pub_plugin,
+                               const scrimmage::PluginPtr &sub_plugin) {
+    if (pub_plugin->parent() == sub_plugin->parent() || range_ < 0) return true;
+
+    Eigen::Vector3d pub_pos, sub_pos;
+    if (!position(pub_plugin, pub_pos) || !position(sub_plugin, sub_pos)) {
+        return true;
+    }
+    return (sub_pos - pub_pos).squaredNorm() <= range_ * range_;
+}
+
+bool LinkNetwork::is_successful_transmission(const scrimmage::PluginPtr &pub_plugin,
+                                             const scrimmage::PluginPtr &sub_plugin) {
+    return prob_transmit_ >= 1.0 || random_->rng_uniform(0, 1) <= prob_transmit_;
+}
+
+double &LinkNetwork::link_free_time(const scrimmage::PluginPtr &plugin) {
+    int id = plugin->parent() == nullptr ? 0 : std::max(0, plugin->parent()->id().id());
+    if (static_cast<size_t>(id) >= link_free_.size()) {
+        link_free_.resize(id + 1, -std::numeric_limits<double>::infinity());
+    }
+    return link_free_[id];
+}
+
+void LinkNetwork::published(const NetworkDevicePtr &pub, MessageQueue &msgs) {
+    pub_has_pos_ = position(pub->plugin(), pub_pos_);
+
+    // Each message is sent once on the publishing node's link, no matter how
+    // many subscribers receive it, and waits for the messages sent before it
+    const double t = time_->t();
+    double &link_free = link_free_time(pub->plugin());
+    sent_time_.resize(msgs.size());
+    for (size_t i = 0; i < msgs.size(); i++) {
+        double start = std::max(t, link_free);
+        if (max_backlog_ >= 0 && start - t > max_backlog_) {
+            sent_time_[i] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+
+        double end = start;
+        if (bandwidth_ > 0) {
+            // C++ messages that aren't protobufs have no size estimate.
+            // Reuse the size from publishing when stats were collected.
+            size_t size = msgs[i]->published_size;
+            if (size == 0) size = msgs[i]->size_bytes();
+            double bytes = size == 0 ? msg_bytes_ : size;
+            end += 8 * bytes / bandwidth_;
+        }
+        link_free = end;
+        sent_time_[i] = end;
+    }
+}
+
+bool LinkNetwork::transmit(const NetworkDevicePtr &pub, const NetworkDevicePtr &sub,
+                           const MessageBasePtr &msg, size_t index) {
+    // messages between plugins on the same entity don't use a link
+    double time = time_->t();
+    if (pub->plugin()->parent() != sub->plugin()->parent()) {
+        time = sent_time_[index];
+        if (std::isnan(time)) return false;
+        time += latency_;
+
+        Eigen::Vector3d sub_pos;
+        if (propagation_speed_ > 0 && pub_has_pos_ && position(sub->plugin(), sub_pos)) {
+            time += (sub_pos - pub_pos_).norm() / propagation_speed_;
+        }
+    }
+
+    in_flight_.push_back(InFlight{time, seq_++, sub, msg});
+    std::push_heap(in_flight_.begin(), in_flight_.end(), std::greater<InFlight>());
+    return true;
+}
+
+} // namespace network
+} // namespace scrimmage
@@ -36,6 +36,7 @@
 #include <scrimmage/common/RTree.h>
 #include <scrimmage/entity/Entity.h>
 #include <scrimmage/math/State.h>
+#include <scrimmage/parse/ParseUtils.h>
 #include <scrimmage/plugin_manager/RegisterPlugin.h>
 #include <scrimmage/plugins/network/SphereNetwork/SphereNetwork.h>
 #include <scrimmage/pubsub/Publisher.h>
@@ -43,6 +44,7 @@
 #include <scrimmage/pubsub/Message.h>
 
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <boost/range/adaptor/map.hpp>
 
@@ -65,51 +67,83 @@ bool SphereNetwork::init(std::map<std::string, std::string> &mission_params,
 
     range_ = std::stod(plugin_params.at("range"));
     prob_transmit_ = std::stod(plugin_params.at("prob_transmit"));
+
+    batch_ = sc::get<bool>("batch", plugin_params, false);
+    if (batch_) {
+        gener_.seed(random_->rng_uniform_int(0, std::numeric_limits<int>::max()));
+        uniforms_.resize(1024);
+        next_uniform_ = uniforms_.size();
+    }
     return true;
 }
 
-bool SphereNetwork::is_reachable(const scrimmage::PluginPtr &pub_plugin,
-                                 const scrimmage::PluginPtr &sub_plugin) {
-    // If the publisher and subscriber have the same parent, it is reachable
-    if (pub_plugin->parent() == sub_plugin->parent()) return true;
+bool SphereNetwork::step(std::map<std::string, std::list<NetworkDevicePtr>> &pubs,
+                         std::map<std::string, std::list<NetworkDevicePtr>> &subs) {
+    // The entities have moved, so the reachable sets have to be recomputed
+    step_++;
+    adj_.clear();
+    marked_pub_ = -1;
+    return Network::step(pubs, subs);
+}
 
-    // Is the publisher to subscriber already in the reachable map?
+void SphereNetwork::mark_reachable(const scrimmage::PluginPtr &pub_plugin) {
     int pub_id = pub_plugin->parent()->id().id();
-    int sub_id = sub_plugin->parent()->id().id();
+    if (static_cast<size_t>(pub_id) >= rows_.size()) {
+        rows_.resize(pub_id + 1);
+    }
 
-    // Find the publisher in the mapping
-    auto it_pub = reachable_map_.find(pub_id);
-    if (it_pub != reachable_map_.end()) {
-        // See if the publisher has a reachability mapping for the subscriber
-        auto it_sub = it_pub->second.find(sub_id);
-        if (it_sub != it_pub->second.end()) {
-            return it_sub->second;
-        }
+    Row &row = rows_[pub_id];
+    if (row.step != step_) {
+        row.step = step_;
+        row.begin = adj_.size();
+
+        // The networks run after the entities moved, so this can't use the
+        // neighbor lists, which are found before they move
+        rtree_->for_each_in_range(pub_plugin->parent()->state()->pos(), range_,
+            [&](const sc::ID &id, double /*dist_sq*/) {adj_.push_back(id.id());});
+        row.end = adj_.size();
     }
 
-    // No reachability mapping exists. Find all entity IDs that are reachable.
-    std::vector<sc::ID> neigh;
-    rtree_->neighbors_in_range(pub_plugin->parent()->state()->pos(), neigh,
-                               range_);
-
-    // Add the entity IDs to the publisher's reachability set
-    // Look for the subscriber ID
-    bool sub_id_found = false;
-    for (sc::ID id : neigh) {
-        reachable_map_[pub_id][id.id()] = true;
-        if (sub_id == id.id()) {
-            sub_id_found = true;
+    mark_++;
+    for (size_t i = row.begin; i < row.end; i++) {
+        int id = adj_[i];
+        if (static_cast<size_t>(id) >= marks_.size()) {
+            marks_.resize(id + 1, 0);
         }
+        marks_[id] = mark_;
     }
+    marked_pub_ = pub_id;
+}
 
-    // Save the reachability for faster lookup
-    reachable_map_[pub_id][sub_id] = sub_id_found;
+bool SphereNetwork::is_reachable(const scrimmage::PluginPtr &pub_plugin,
+                                 const scrimmage::PluginPtr &sub_plugin) {
+    // If the publisher and subscriber have the same parent, it is reachable
+    if (pub_plugin->parent() == sub_plugin->parent()) return true;
+
+    // A publisher's messages are sent to all of its subscribers in a row, so
+    // its reachable set is only marked again when the publisher changes
+    if (pub_plugin->parent()->id().id() != marked_pub_) {
+        mark_reachable(pub_plugin);
+    }
 
-    return sub_id_found;
+    int sub_id = sub_plugin->parent()->id().id();
+    return static_cast<size_t>(sub_id) < marks_.size() && marks_[sub_id] == mark_;
+}
+
+double SphereNetwork::draw_uniform() {
+    if (next_uniform_ == uniforms_.size()) {
+        std::uniform_real_distribution<double> dist(0, 1);
+        for (double &u : uniforms_) u = dist(gener_);
+        next_uniform_ = 0;
+    }
+    return uniforms_[next_uniform_++];
 }
 
 bool SphereNetwork::is_successful_transmission(const scrimmage::PluginPtr &pub_plugin,
                                                const scrimmage::PluginPtr &sub_plugin) {
+    if (batch_) {
+        return prob_transmit_ >= 1.0 || draw_uniform() <= prob_transmit_;
+    }
     return (random_->rng_uniform(0, 1) <= prob_transmit_);
 }
 
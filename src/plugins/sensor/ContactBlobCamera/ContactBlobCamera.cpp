@@ -44,6 +44,7 @@
 #include <scrimmage/parse/ParseUtils.h>
 
 #include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessagePool.h>
 #include <scrimmage/proto/State.pb.h>
 #include <scrimmage/common/Random.h>
 #include <scrimmage/math/Quaternion.h>
@@ -117,7 +118,7 @@ void ContactBlobCamera::init(std::map<std::string, std::string> &params) {
 }
 
 sc::MessageBasePtr ContactBlobCamera::sensor_msg(double t) {
-    auto msg = std::make_shared<sc::Message<ContactBlobCameraType>>();
+    auto msg = sc::make_msg<ContactBlobCameraType>();
 
     if ((t - last_frame_t_) < 1.0 / fps_) {
         return std::make_shared<sc::MessageBase>();
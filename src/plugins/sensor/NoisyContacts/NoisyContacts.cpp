@@ -44,6 +44,7 @@
 #include <scrimmage/proto/Shape.pb.h>
 #include <scrimmage/proto/State.pb.h>
 #include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessagePool.h>
 
 #include <vector>
 
@@ -66,6 +67,7 @@ void NoisyContacts::init(std::map<std::string, std::string> &params) {
     gener_ = parent_->random()->gener();
 
     max_detect_range_ = sc::get<double>("max_detect_range", params, 1000);
+    radius_id_ = parent_->rtree()->register_neighbor_radius(max_detect_range_);
     az_thresh_ = sc::Angles::deg2rad(sc::get<double>("azimuth_fov", params, 360));
     el_thresh_ = sc::Angles::deg2rad(sc::get<double>("elevation_fov", params, 360));
 
@@ -91,7 +93,7 @@ void NoisyContacts::init(std::map<std::string, std::string> &params) {
 }
 
 scrimmage::MessageBasePtr NoisyContacts::sensor_msg(double t) {
-    auto msg = std::make_shared<sc::Message<std::list<sc::Contact>>>();
+    auto msg = sc::make_msg<std::list<sc::Contact>>();
 
     auto state = parent_->state();
     auto contacts = parent_->contacts();
@@ -121,8 +123,14 @@ scrimmage::MessageBasePtr NoisyContacts::sensor_msg(double t) {
     };
 
     std::vector<ID> neigh_in_range;
-    parent_->rtree()->neighbors_in_range(
-        state->pos(), neigh_in_range, max_detect_range_, parent_->id().id());
+    NeighborList list;
+    if (parent_->rtree()->neighbor_list(radius_id_, parent_->id().id(), list)) {
+        neigh_in_range.reserve(list.size());
+        for (const Neighbor &n : list) neigh_in_range.push_back(n.id);
+    } else {
+        parent_->rtree()->neighbors_in_range(
+            state->pos(), neigh_in_range, max_detect_range_, parent_->id().id());
+    }
 
     br::transform(neigh_in_range | ba::filtered(in_fov),
                   std::inserter(msg->data, msg->data.end()),
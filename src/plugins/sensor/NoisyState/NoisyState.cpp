@@ -44,6 +44,7 @@
 #include <scrimmage/parse/ParseUtils.h>
 
 #include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessagePool.h>
 #include <scrimmage/proto/State.pb.h>
 #include <scrimmage/common/Random.h>
 #include <scrimmage/math/Quaternion.h>
@@ -101,7 +102,7 @@ scrimmage::MessageBasePtr NoisyState::sensor_msg(double t) {
     // Make a copy of the current state
     sc::State ns = *(parent_->state());
 
-    auto msg = std::make_shared<sc::Message<sc::State>>();
+    auto msg = sc::make_msg<sc::State>();
 
     for (int i = 0; i < 3; i++) {
         msg->data.pos()(i) = ns.pos()(i) + (*pos_noise_[i])(*gener_);
@@ -40,6 +40,7 @@
 #include <scrimmage/parse/ParseUtils.h>
 #include <scrimmage/proto/State.pb.h>
 #include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessagePool.h>
 #include <scrimmage/common/Random.h>
 #include <scrimmage/math/Quaternion.h>
 
@@ -91,7 +92,7 @@ void RigidBody6DOFStateSensor::init(std::map<std::string, std::string> &params)
 }
 
 scrimmage::MessageBasePtr RigidBody6DOFStateSensor::sensor_msg(double t) {
-    auto msg = std::make_shared<sc::Message<sc::motion::RigidBody6DOFState>>();
+    auto msg = sc::make_msg<sc::motion::RigidBody6DOFState>();
 
     // Copy elements from scrimmage::State
     msg->data.pos() = parent_->state()->pos();
@@ -37,6 +37,7 @@
 #include <scrimmage/proto/ProtoConversions.h>
 #include <scrimmage/proto/Shape.pb.h>
 #include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessagePool.h>
 #include <scrimmage/autonomy/Autonomy.h>
 #include <scrimmage/parse/ParseUtils.h>
 #include <scrimmage/plugin_manager/RegisterPlugin.h>
@@ -66,7 +67,7 @@ void SimpleCamera::init(std::map<std::string, std::string> &params) {
 scrimmage::MessageBasePtr SimpleCamera::sensor_msg(double t) {
 
     int my_id = parent_->id().id();
-    auto msg = std::make_shared<sc::Message<std::unordered_set<sc::ID>>>();
+    auto msg = sc::make_msg<std::unordered_set<sc::ID>>();
 
     std::vector<sc::ID> neigh;
     sc::ContactMapPtr c = parent_->contacts();
@@ -201,52 +201,51 @@ Frame proto_2_frame(const scrimmage_proto::Frame &proto_frame) {
     return frame;
 }
 
+void set(scrimmage_proto::Contact *dst, const ID &id, Contact::Type type,
+         bool active, const double *pos, const double *vel, const double *quat) {
+    scrimmage_proto::State *sp_state = dst->mutable_state();
+    scrimmage_proto::Vector3d *sp_pos = sp_state->mutable_position();
+    scrimmage_proto::Vector3d *sp_vel = sp_state->mutable_velocity();
+    scrimmage_proto::Quaternion *sp_quat = sp_state->mutable_orientation();
+    scrimmage_proto::ID *sp_id = dst->mutable_id();
+
+    sp_pos->set_x(pos[0]);
+    sp_pos->set_y(pos[1]);
+    sp_pos->set_z(pos[2]);
+
+    sp_vel->set_x(vel[0]);
+    sp_vel->set_y(vel[1]);
+    sp_vel->set_z(vel[2]);
+
+    sp_quat->set_x(quat[0]);
+    sp_quat->set_y(quat[1]);
+    sp_quat->set_z(quat[2]);
+    sp_quat->set_w(quat[3]);
+
+    switch (type) {
+    case Contact::Type::AIRCRAFT: dst->set_type(scrimmage_proto::AIRCRAFT); break;
+    case Contact::Type::QUADROTOR: dst->set_type(scrimmage_proto::QUADROTOR); break;
+    case Contact::Type::SPHERE: dst->set_type(scrimmage_proto::SPHERE); break;
+    case Contact::Type::MESH: dst->set_type(scrimmage_proto::MESH); break;
+    default: dst->set_type(scrimmage_proto::UNKNOWN);
+    }
+
+    dst->set_active(active);
+
+    sp_id->set_id(id.id());
+    sp_id->set_sub_swarm_id(id.sub_swarm_id());
+    sp_id->set_team_id(id.team_id());
+}
+
 std::shared_ptr<scrimmage_proto::Frame> create_frame(double time, std::shared_ptr<ContactMap> &contacts) {
     std::shared_ptr<scrimmage_proto::Frame> frame(new scrimmage_proto::Frame());
     frame->set_time(time);
 
     for (auto &kv : *contacts) {
-
         StatePtr &state = kv.second.state();
-        Eigen::Vector3d &pos = state->pos();
-        Eigen::Vector3d &vel = state->vel();
-        Quaternion &quat = state->quat();
-        Contact::Type type = kv.second.type();
-        const ID &id = kv.second.id();
-
-        scrimmage_proto::Contact *contact = frame->add_contact();
-        scrimmage_proto::State *sp_state = contact->mutable_state();
-        scrimmage_proto::Vector3d *sp_pos = sp_state->mutable_position();
-        scrimmage_proto::Vector3d *sp_vel = sp_state->mutable_velocity();
-        scrimmage_proto::Quaternion *sp_quat = sp_state->mutable_orientation();
-        scrimmage_proto::ID *sp_id = contact->mutable_id();
-
-        sp_pos->set_x(pos(0));
-        sp_pos->set_y(pos(1));
-        sp_pos->set_z(pos(2));
-
-        sp_vel->set_x(vel(0));
-        sp_vel->set_y(vel(1));
-        sp_vel->set_z(vel(2));
-
-        sp_quat->set_x(quat.x());
-        sp_quat->set_y(quat.y());
-        sp_quat->set_z(quat.z());
-        sp_quat->set_w(quat.w());
-
-        switch (type) {
-        case Contact::Type::AIRCRAFT: contact->set_type(scrimmage_proto::AIRCRAFT); break;
-        case Contact::Type::QUADROTOR: contact->set_type(scrimmage_proto::QUADROTOR); break;
-        case Contact::Type::SPHERE: contact->set_type(scrimmage_proto::SPHERE); break;
-        case Contact::Type::MESH: contact->set_type(scrimmage_proto::MESH); break;
-        default: contact->set_type(scrimmage_proto::UNKNOWN);
-        }
-
-        contact->set_active(kv.second.active());
-
-        sp_id->set_id(id.id());
-        sp_id->set_sub_swarm_id(id.sub_swarm_id());
-        sp_id->set_team_id(id.team_id());
+        set(frame->add_contact(), kv.second.id(), kv.second.type(),
+            kv.second.active(), state->pos().data(), state->vel().data(),
+            state->quat().coeffs().data());
     }
     return frame;
 }
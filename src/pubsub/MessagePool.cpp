@@ -0,0 +1,101 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/pubsub/MessagePool.h>
+
+#include <array>
+#include <new>
+#include <vector>
+
+namespace scrimmage {
+
+namespace {
+constexpr size_t num_classes = MessagePool::max_block_size / MessagePool::size_class_bytes;
+
+size_t size_class(size_t bytes) {
+    return (bytes + MessagePool::size_class_bytes - 1) / MessagePool::size_class_bytes - 1;
+}
+
+struct FreeLists {
+    std::array<std::vector<void*>, num_classes> blocks;
+    ~FreeLists();
+};
+
+// Messages can be freed while a thread is exiting, after its free lists have
+// been destroyed. This flag has no destructor, so it can still be read then.
+thread_local bool free_lists_destroyed = false;
+thread_local FreeLists free_lists;
+
+FreeLists::~FreeLists() {
+    for (auto &list : blocks) {
+        for (void *p : list) ::operator delete(p);
+    }
+    free_lists_destroyed = true;
+}
+} // namespace
+
+constexpr size_t MessagePool::size_class_bytes;
+constexpr size_t MessagePool::max_block_size;
+constexpr size_t MessagePool::max_free_blocks;
+
+void *MessagePool::allocate(size_t bytes) {
+    if (bytes == 0 || bytes > max_block_size) {
+        return ::operator new(bytes);
+    }
+
+    // Blocks are always the full size of their class, since they can be
+    // freed onto another thread's list
+    size_t c = size_class(bytes);
+    if (free_lists_destroyed || free_lists.blocks[c].empty()) {
+        return ::operator new((c + 1) * size_class_bytes);
+    }
+    std::vector<void*> &list = free_lists.blocks[c];
+    void *p = list.back();
+    list.pop_back();
+    return p;
+}
+
+void MessagePool::deallocate(void *p, size_t bytes) {
+    if (bytes == 0 || bytes > max_block_size || free_lists_destroyed) {
+        ::operator delete(p);
+        return;
+    }
+
+    std::vector<void*> &list = free_lists.blocks[size_class(bytes)];
+    if (list.size() >= max_free_blocks) {
+        ::operator delete(p);
+    } else {
+        list.push_back(p);
+    }
+}
+
+} // namespace scrimmage
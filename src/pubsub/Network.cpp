@@ -38,6 +38,7 @@
 #include <scrimmage/parse/MissionParse.h>
 #include <scrimmage/pubsub/Network.h>
 #include <scrimmage/pubsub/NetworkDevice.h>
+#include <scrimmage/pubsub/PubSub.h>
 #include <scrimmage/pubsub/Publisher.h>
 #include <scrimmage/pubsub/SubscriberBase.h>
 
@@ -77,6 +78,8 @@ bool Network::network_init(std::map<std::string, std::string> &mission_params,
 
     setup_counts("monitor_publisher_topics", plugin_params, pub_counts_, monitor_all_pubs_);
     setup_counts("monitor_subscriber_topics", plugin_params, sub_counts_, monitor_all_subs_);
+    all_pub_count_ = count(pub_counts_, "*");
+    all_sub_count_ = count(sub_counts_, "*");
 
     // Should we write a CSV file? What values should be written?
     std::string filename = get<std::string>("csv_filename", plugin_params, "");
@@ -98,6 +101,62 @@ bool Network::network_init(std::map<std::string, std::string> &mission_params,
     return true;
 }
 
+unsigned int *Network::count(std::map<std::string, unsigned int> &counts,
+                             const std::string &topic) {
+    auto it = counts.find(topic);
+    return it == counts.end() ? nullptr : &it->second;
+}
+
+template <class Devices>
+void Network::deliver(NetworkDevicePtr &pub, Devices &subs, unsigned int *pub_count) {
+    // Popping bounds a device's queue to its max size, which is also how the
+    // subscriber queues are bounded
+    pub->pop_msgs(msgs_);
+    if (msgs_.empty()) {
+        return;
+    }
+    published(pub, msgs_);
+
+    if (monitor_all_pubs_) {
+        // Accumulate published message counts on all topics
+        *all_pub_count_ += msgs_.size();
+    }
+
+    if (pub_count != nullptr) {
+        // Accumulate published message counts on specific topic
+        *pub_count += msgs_.size();
+    }
+
+    // For all subscribers on this topic
+    for (NetworkDevicePtr &sub : subs) {
+        if (is_reachable(pub->plugin(), sub->plugin())) {
+            for (size_t i = 0; i < msgs_.size(); i++) {
+                if (is_successful_transmission(pub->plugin(),
+                                               sub->plugin())) {
+                    msgs_[i]->time = time_->t();
+                    transmit(pub, sub, msgs_[i], i);
+                }
+            }
+        }
+    }
+}
+
+void Network::delivered(const NetworkDevicePtr &sub) {
+    if (monitor_all_subs_) {
+        // Accumulate received message counts on all topics
+        *all_sub_count_ += 1;
+    }
+
+    const int id = sub->topic_id();
+    unsigned int *sub_count =
+        id >= 0 && static_cast<size_t>(id) < topic_sub_counts_.size() ?
+        topic_sub_counts_[id] : count(sub_counts_, sub->get_topic());
+    if (sub_count != nullptr) {
+        // Accumulate received message counts on specific topic
+        *sub_count += 1;
+    }
+}
+
 bool Network::step(std::map<std::string, std::list<NetworkDevicePtr>> &pubs,
                    std::map<std::string, std::list<NetworkDevicePtr>> &subs) {
     reachable_map_.clear();
@@ -110,75 +169,39 @@ bool Network::step(std::map<std::string, std::list<NetworkDevicePtr>> &pubs,
         kv.second = 0;
     }
 
-    // Get references to the "all topics" string for faster access later
-    auto it_all_pub = pub_counts_.find("*");
-    auto it_all_sub = sub_counts_.find("*");
-
-    // For all publisher topic names
-    for (auto &pub_kv : pubs) {
-        std::string topic = pub_kv.first;
-
-        // Get reference to this specific topic in the pub_counts_ map for
-        // faster access later
-        auto it_pub_topic = pub_counts_.find(topic);
-        bool valid_pub_topic = (it_pub_topic != pub_counts_.end());
-
-        // Get reference to this specific topic in the sub_counts_ map for
-        // faster access later
-        auto it_sub_topic = sub_counts_.find(topic);
-        bool valid_sub_topic = (it_sub_topic != sub_counts_.end());
-
-        // For all publisher devices with topic name
-        for (NetworkDevicePtr &pub : pub_kv.second) {
-            pub->enforce_queue_size();
-
-            auto msgs = pub->pop_msgs<MessageBase>();
-            if (msgs.empty()) {
-                continue;
-            }
-
-            if (monitor_all_pubs_) {
-                // Accumulate published message counts on all topics
-                it_all_pub->second += msgs.size();
-            }
+    PubSub::NetworkRoutes *routes =
+        pubsub_ == nullptr ? nullptr : pubsub_->routes(name());
 
-            if (valid_pub_topic) {
-                // Accumulate published message counts on specific topic
-                it_pub_topic->second += msgs.size();
-            }
+    if (routes != nullptr) {
+        // The topics were interned by the pubsub when they were advertised
+        // or subscribed to, so only new topics have their counts looked up
+        for (size_t id = topic_pub_counts_.size(); id < routes->topics.size(); id++) {
+            const std::string &topic = routes->topics[id].topic;
+            topic_pub_counts_.push_back(count(pub_counts_, topic));
+            topic_sub_counts_.push_back(count(sub_counts_, topic));
+        }
 
-            // For all subscribers on this topic
-            for (NetworkDevicePtr &sub : subs[topic]) {
-                if (is_reachable(pub->plugin(), sub->plugin())) {
-                    for (auto &msg : msgs) {
-                        if (is_successful_transmission(pub->plugin(),
-                                                       sub->plugin())) {
-                            msg->time = time_->t();
-                            sub->add_msg(msg);
-
-                            if (monitor_all_subs_) {
-                                // Accumulate received message counts on all topics
-                                it_all_sub->second += 1;
-                            }
-
-                            if (valid_sub_topic) {
-                                // Accumulate received message counts on specific topic
-                                it_sub_topic->second += 1;
-                            }
-                        }
-                    }
-                }
+        // Route the topics in name order, the same as the topic maps, so
+        // that the transmission draws from the random generator are made
+        // in the same order
+        for (int id : routes->order) {
+            PubSub::TopicRoute &route = routes->topics[id];
+            for (NetworkDevicePtr &pub : route.pubs) {
+                deliver(pub, route.subs, topic_pub_counts_[id]);
             }
         }
-    }
-
-    // Enforce queue sizes, if necessary
-    for (auto &sub_kv : subs) {
-        // For all publisher devices with topic name
-        for (NetworkDevicePtr &sub : sub_kv.second) {
-            sub->enforce_queue_size();
+    } else {
+        // For all publisher topic names
+        for (auto &pub_kv : pubs) {
+            unsigned int *pub_count = count(pub_counts_, pub_kv.first);
+            auto &topic_subs = subs[pub_kv.first];
+            for (NetworkDevicePtr &pub : pub_kv.second) {
+                deliver(pub, topic_subs, pub_count);
+            }
         }
     }
+    msgs_.clear();
+    routed();
 
     if (write_csv_) {
         CSV::Pairs pairs;
@@ -199,6 +222,14 @@ bool Network::step(std::map<std::string, std::list<NetworkDevicePtr>> &pubs,
     return true;
 }
 
+bool Network::transmit(const NetworkDevicePtr &/*pub*/, const NetworkDevicePtr &sub,
+                       const MessageBasePtr &msg, size_t /*index*/) {
+    // subscribers share the message, only its reference count changes
+    sub->add_msg(msg);
+    delivered(sub);
+    return true;
+}
+
 bool Network::is_reachable(const scrimmage::PluginPtr &pub_plugin,
                            const scrimmage::PluginPtr &sub_plugin) {
     return false;
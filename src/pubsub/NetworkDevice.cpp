@@ -35,6 +35,7 @@
 #include <scrimmage/plugin_manager/Plugin.h>
 
 #include <iostream>
+#include <utility>
 
 namespace scrimmage {
 
@@ -44,17 +45,26 @@ NetworkDevice::NetworkDevice(const std::string &topic, unsigned int &max_queue_s
                              bool enable_queue_size, PluginPtr plugin) :
     topic_(topic), max_queue_size_(max_queue_size),
     enable_queue_size_(enable_queue_size), plugin_(plugin) {
+    update_queue_capacity();
 }
 
 NetworkDevice::NetworkDevice(NetworkDevice &rhs) :
     topic_(rhs.topic_),
+    topic_id_(rhs.topic_id_),
+    notify_plugin_(rhs.notify_plugin_),
     max_queue_size_(rhs.max_queue_size_),
+    enable_queue_size_(rhs.enable_queue_size_),
+    collect_stats_(rhs.collect_stats_),
     plugin_(rhs.plugin_),
-    msg_list_(rhs.msg_list_) {}
+    msg_queue_(rhs.msg_queue_) {}
 
 NetworkDevice::NetworkDevice(NetworkDevice &&rhs) :
-    topic_(rhs.topic_), max_queue_size_(rhs.max_queue_size_),
-    msg_list_(rhs.msg_list_) {
+    topic_(rhs.topic_), topic_id_(rhs.topic_id_),
+    notify_plugin_(rhs.notify_plugin_),
+    max_queue_size_(rhs.max_queue_size_),
+    enable_queue_size_(rhs.enable_queue_size_),
+    collect_stats_(rhs.collect_stats_),
+    msg_queue_(rhs.msg_queue_) {
 }
 
 std::string NetworkDevice::get_topic() const {return topic_;}
@@ -62,13 +72,18 @@ std::string NetworkDevice::get_topic() const {return topic_;}
 void NetworkDevice::set_topic(const std::string &topic) {topic_ = topic;}
 
 void NetworkDevice::set_msg_list(const std::list<MessageBasePtr> &msg_list) {
-    mutex_.lock();
-    msg_list_ = msg_list;
-    mutex_.unlock();
+    msg_queue_.clear();
+    for (const MessageBasePtr &msg : msg_list) {
+        msg_queue_.push(msg);
+    }
+    if (notify_plugin_ && plugin_ && !msg_list.empty()) {
+        plugin_->set_pending_msgs();
+    }
 }
 
 void NetworkDevice::set_max_queue_size(unsigned int size) {
     max_queue_size_ = size;
+    update_queue_capacity();
 }
 
 unsigned int NetworkDevice::max_queue_size() {
@@ -77,34 +92,51 @@ unsigned int NetworkDevice::max_queue_size() {
 
 void NetworkDevice::enable_queue_size(bool enforce) {
     enable_queue_size_ = enforce;
+    update_queue_capacity();
 }
 
 bool NetworkDevice::enable_queue_size() {
     return enable_queue_size_;
 }
 
+void NetworkDevice::update_queue_capacity() {
+    // A bounded device queues into a ring that overwrites its oldest message,
+    // so it never holds more than max_queue_size messages between pops
+    msg_queue_.set_capacity(enable_queue_size_ ? max_queue_size_ : 0);
+}
+
 void NetworkDevice::enforce_queue_size() {
-    if (enable_queue_size_) {
-        if (msg_list_.size() > max_queue_size_) {
-            mutex_.lock();
-            auto erase_end = msg_list_.begin();
-            std::advance(erase_end, msg_list_.size() - max_queue_size_);
-            msg_list_.erase(msg_list_.begin(), erase_end);
-            mutex_.unlock();
-        }
+    // The ring is already bounded. Only a bound of zero messages, which
+    // can't be a ring, is left to enforce.
+    if (enable_queue_size_ && max_queue_size_ == 0 && !msg_queue_.empty()) {
+        MessageQueue msgs;
+        stats_.dropped += msg_queue_.drain(msgs, 0);
     }
 }
 
 void NetworkDevice::add_msg(MessageBasePtr msg) {
-    mutex_.lock();
-    msg_list_.push_back(msg);
-    mutex_.unlock();
+    msg_queue_.push(std::move(msg));
+    if (notify_plugin_ && plugin_) {
+        plugin_->set_pending_msgs();
+    }
+}
+
+void NetworkDevice::pop_msgs(MessageQueue &msgs) {
+    msgs.clear();
+    size_t dropped = enable_queue_size_ ?
+        msg_queue_.drain(msgs, max_queue_size_) : msg_queue_.drain(msgs);
+
+    uint64_t bytes = 0;
+    if (collect_stats_) {
+        for (size_t i = 0; i < msgs.size(); i++) {
+            if (msgs[i]) bytes += msgs[i]->published_size;
+        }
+    }
+    stats_.add_pop(msgs.size(), bytes, dropped);
 }
 
 void NetworkDevice::clear_msg_list() {
-    mutex_.lock();
-    msg_list_.clear();
-    mutex_.unlock();
+    msg_queue_.clear();
 }
 
 void NetworkDevice::print_str(const std::string &msg) {
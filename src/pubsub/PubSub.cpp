@@ -34,6 +34,7 @@
 #include <scrimmage/pubsub/PubSub.h>
 #include <scrimmage/pubsub/Publisher.h>
 
+#include <algorithm>
 #include <iostream>
 
 #include <boost/optional.hpp>
@@ -63,9 +64,76 @@ PublisherPtr PubSub::advertise(std::string &network_name, const std::string &top
     PublisherPtr pub = std::make_shared<Publisher>(topic, max_queue_size,
                                                    enable_queue_size, plugin);
     pub_map_[network_name][topic].push_back(pub);
+    add_route(network_name, pub, true);
     return pub;
 }
 
+int PubSub::topic_id(const std::string &network_name, const std::string &topic) {
+    NetworkRoutes &routes = routes_[network_name];
+    auto it = routes.ids.find(topic);
+    if (it != routes.ids.end()) {
+        return it->second;
+    }
+
+    int id = static_cast<int>(routes.topics.size());
+    routes.ids[topic] = id;
+    routes.topics.emplace_back();
+    routes.topics.back().topic = topic;
+
+    // keep the order of the topic maps, which are sorted by name
+    auto pos = std::lower_bound(routes.order.begin(), routes.order.end(), topic,
+        [&](int other, const std::string &t) {return routes.topics[other].topic < t;});
+    routes.order.insert(pos, id);
+    return id;
+}
+
+void PubSub::add_route(const std::string &network_name, NetworkDevicePtr dev, bool pub) {
+    int id = topic_id(network_name, dev->get_topic());
+    dev->set_topic_id(id);
+    dev->collect_stats(collect_stats_);
+    TopicRoute &route = routes_[network_name].topics[id];
+    (pub ? route.pubs : route.subs).push_back(dev);
+}
+
+PubSub::NetworkRoutes *PubSub::routes(const std::string &network_name) {
+    auto it = routes_.find(network_name);
+    return it == routes_.end() ? nullptr : &it->second;
+}
+
+void PubSub::collect_stats(bool collect) {
+    collect_stats_ = collect;
+    for (auto &kv : routes_) {
+        for (TopicRoute &route : kv.second.topics) {
+            for (NetworkDevicePtr &pub : route.pubs) pub->collect_stats(collect);
+            for (NetworkDevicePtr &sub : route.subs) sub->collect_stats(collect);
+        }
+    }
+}
+
+std::vector<TopicStats> PubSub::topic_stats() {
+    std::vector<TopicStats> stats;
+    for (auto &kv : routes_) {
+        for (int id : kv.second.order) {
+            const TopicRoute &route = kv.second.topics[id];
+            stats.emplace_back();
+            TopicStats &s = stats.back();
+            s.network = kv.first;
+            s.topic = route.topic;
+            s.num_pubs = route.pubs.size();
+            s.num_subs = route.subs.size();
+            for (const NetworkDevicePtr &pub : route.pubs) s.pubs.merge(pub->stats());
+            for (const NetworkDevicePtr &sub : route.subs) s.subs.merge(sub->stats());
+        }
+    }
+    return stats;
+}
+
+void PubSub::clear() {
+    pub_map_.clear();
+    sub_map_.clear();
+    routes_.clear();
+}
+
 boost::optional<std::list<NetworkDevicePtr>> PubSub::find_devices(
     const std::string &network_name, const std::string &topic_name, TopicMap &devs) {
 
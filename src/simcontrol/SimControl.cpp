@@ -42,6 +42,7 @@
 #include <scrimmage/common/Time.h>
 #include <scrimmage/entity/Contact.h>
 #include <scrimmage/common/RTree.h>
+#include <scrimmage/common/SpatialHash.h>
 #include <scrimmage/entity/Entity.h>
 #include <scrimmage/motion/MotionModel.h>
 #include <scrimmage/motion/Controller.h>
@@ -53,6 +54,7 @@
 #include <scrimmage/autonomy/Autonomy.h>
 
 #include <scrimmage/math/State.h>
+#include <scrimmage/math/StateStore.h>
 
 #include <scrimmage/proto/ProtoConversions.h>
 #include <scrimmage/proto/Visual.pb.h>
@@ -63,12 +65,16 @@
 #include <scrimmage/pubsub/PubSub.h>
 #include <scrimmage/pubsub/Message.h>
 
+#include <scrimmage/msgs/Capture.pb.h>
+#include <scrimmage/msgs/Collision.pb.h>
 #include <scrimmage/msgs/Event.pb.h>
 
+#include <algorithm>
+#include <chrono> // NOLINT
 #include <iostream>
 #include <string>
 #include <memory>
-#include <future> // NOLINT
+#include <vector>
 
 #include <GeographicLib/LocalCartesian.hpp>
 
@@ -117,8 +123,7 @@ bool SimControl::init() {
     shapes_.clear();
     contact_visuals_.clear();
     networks_->clear();
-    pubsub_->pubs().clear();
-    pubsub_->subs().clear();
+    pubsub_->clear();
 
     if (mp_ == NULL) {
         cout << "Mission Parse hasn't been set yet." << endl;
@@ -167,8 +172,27 @@ bool SimControl::init() {
     }
 
     rtree_ = std::make_shared<scrimmage::RTree>();
+    std::string neighbor_index = get<std::string>("neighbor_index", mp_->params(), "rtree");
+    if (neighbor_index == "spatial_hash") {
+        auto &attr = mp_->attributes()["neighbor_index"];
+        rtree_->set_index(std::make_shared<SpatialHash>(get("cell_size", attr, 0.0)));
+    } else if (neighbor_index != "rtree") {
+        std::cout << "Unknown neighbor_index: " << neighbor_index
+                  << ", using rtree" << std::endl;
+    }
     rtree_->init(max_num_entities);
 
+    state_store_ = std::make_shared<StateStore>();
+
+    incremental_rtree_ = get("incremental_rtree", mp_->params(), false);
+    if (incremental_rtree_) {
+        auto &attr = mp_->attributes()["incremental_rtree"];
+        rtree_->set_rebuild_fraction(get("rebuild_fraction", attr, 0.5));
+    }
+    rtree_time_ = 0;
+    neighbor_lists_ = get("neighbor_lists", mp_->params(), false);
+    neighbor_lists_time_ = 0;
+
     // What is the end condition?
     if (mp_->params().count("end_condition") > 0) {
         std::string cond = mp_->params()["end_condition"];
@@ -308,7 +332,7 @@ bool SimControl::init() {
     info.id_to_ent_map = id_to_ent_map_;
 
     if (!create_metrics(info, metrics_)) return false;
-    if (!create_ent_inters(info, shapes_[0], ent_inters_)) return false;
+    if (!create_ent_inters(info, shapes_, ent_inters_)) return false;
 
     contacts_mutex_.lock();
     contacts_->reserve(max_num_entities+1);
@@ -320,12 +344,61 @@ bool SimControl::init() {
 
     use_entity_threads_ = get("multi_threaded", mp_->params(), false);
     if (use_entity_threads_) {
-        entity_pool_stop_ = false;
-        num_entity_threads_ = get("num_threads", mp_->attributes()["multi_threaded"], 1);
-        entity_worker_threads_.clear();
-        entity_worker_threads_.reserve(num_entity_threads_);
-        for (int i = 0; i < num_entity_threads_; i++) {
-            entity_worker_threads_.push_back(std::thread(&SimControl::worker, this));
+        auto &attr = mp_->attributes()["multi_threaded"];
+        num_entity_threads_ = get("num_threads", attr, 1);
+        parallel_motion_ = get("parallel_motion", attr, false);
+        scheduler_.clear_stats();
+        scheduler_.start(num_entity_threads_, get<size_t>("chunk_size", attr, 0));
+    }
+    thread_shapes_.clear();
+    thread_shapes_.resize(std::max(1, scheduler_.num_threads()));
+
+    if (get("async_logging", mp_->params(), false)) {
+        auto &attr = mp_->attributes()["async_logging"];
+        FrameLogger::Policy policy = FrameLogger::Policy::BLOCK;
+        std::string policy_str = get("policy", attr, std::string("block"));
+        if (!FrameLogger::parse_policy(policy_str, policy)) {
+            cout << "Unknown async_logging policy: " << policy_str
+                 << ", using block" << endl;
+        }
+        frame_logger_.start(outgoing_interface_,
+                            get<size_t>("queue_size", attr, 64), policy);
+    }
+
+    frame_log_policy_ = FrameLogPolicy();
+    if (get("frame_logging", mp_->params(), false)) {
+        auto &attr = mp_->attributes()["frame_logging"];
+        frame_log_policy_.set_rate(get("rate", attr, 0.0));
+        frame_log_policy_.set_dead_band(get("dead_band", attr, 0.0));
+        frame_log_policy_.set_event_window(get("pre", attr, 1.0),
+                                           get("post", attr, 1.0));
+
+        // the frames around these GlobalNetwork events are logged
+        auto on_event = [this](auto &) {frame_log_policy_.add_event(t_ + dt_);};
+        std::vector<std::string> events;
+        split(events, get("events", attr, std::string("")), ", ");
+        for (const std::string &event : events) {
+            if (event.empty()) {
+                continue;
+            } else if (event == "EntityGenerated") {
+                sim_plugin_->subscribe<sm::EntityGenerated>("GlobalNetwork", event, on_event);
+            } else if (event == "EntityRemoved") {
+                sim_plugin_->subscribe<sm::EntityRemoved>("GlobalNetwork", event, on_event);
+            } else if (event == "TeamCollision") {
+                sim_plugin_->subscribe<sm::TeamCollision>("GlobalNetwork", event, on_event);
+            } else if (event == "NonTeamCollision") {
+                sim_plugin_->subscribe<sm::NonTeamCollision>("GlobalNetwork", event, on_event);
+            } else if (event == "GroundCollision") {
+                sim_plugin_->subscribe<sm::GroundCollision>("GlobalNetwork", event, on_event);
+            } else if (event == "TeamCapture") {
+                sim_plugin_->subscribe<sm::TeamCapture>("GlobalNetwork", event, on_event);
+            } else if (event == "NonTeamCapture") {
+                sim_plugin_->subscribe<sm::NonTeamCapture>("GlobalNetwork", event, on_event);
+            } else {
+                cout << "Unknown frame_logging event: " << event << endl;
+                continue;
+            }
+            frame_log_policy_.set_events_enabled(true);
         }
     }
 
@@ -482,6 +555,7 @@ bool SimControl::generate_entities(double t) {
 
             std::shared_ptr<Entity> ent = std::make_shared<Entity>();
             ent->set_random(random_);
+            ent->set_state_store(state_store_);
 
             contacts_mutex_.lock();
             AttributeMap &attr_map = mp_->entity_attributes()[ent_desc_id];
@@ -517,7 +591,7 @@ bool SimControl::generate_entities(double t) {
                     ent->type(), ent->contact_visual(), ent->properties());
             contacts_mutex_.unlock();
 
-            auto msg = std::make_shared<Message<sm::EntityGenerated>>();
+            auto msg = pub_ent_gen_->make_msg<sm::EntityGenerated>();
             msg->data.set_entity_id(ent->id().id());
             pub_ent_gen_->publish(msg);
 
@@ -569,9 +643,36 @@ void SimControl::join() {
 }
 
 void SimControl::create_rtree() {
-    rtree_->clear();
-    for (EntityPtr &ent: ents_) {
-        rtree_->add(ent->state()->pos(), ent->id());
+    auto t0 = std::chrono::steady_clock::now();
+    if (incremental_rtree_) {
+        state_store_->for_each([&](int slot) {
+            rtree_->update(state_store_->pos(slot), state_store_->id(slot));
+        });
+        rtree_->commit();
+    } else {
+        rtree_->clear();
+        state_store_->for_each([&](int slot) {
+            rtree_->add(state_store_->pos(slot), state_store_->id(slot));
+        });
+    }
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    rtree_time_ += dt.count();
+
+    if (neighbor_lists_ && rtree_->num_neighbor_radii() > 0) {
+        t0 = std::chrono::steady_clock::now();
+        size_t n = rtree_->begin_neighbor_lists(scheduler_.num_threads());
+        if (use_entity_threads_) {
+            scheduler_.run("neighbor_lists", n,
+                [&](size_t begin, size_t end, int thread_id) {
+                    rtree_->compute_neighbor_lists(begin, end, thread_id);
+                    return true;
+                });
+        } else {
+            rtree_->compute_neighbor_lists(0, n, 0);
+        }
+        rtree_->finish_neighbor_lists();
+        dt = std::chrono::steady_clock::now() - t0;
+        neighbor_lists_time_ += dt.count();
     }
 }
 
@@ -608,9 +709,7 @@ bool SimControl::run_networks() {
         }
         all_true &= result;
 
-        shapes_[0].insert(shapes_[0].end(), kv.second->shapes().begin(),
-                          kv.second->shapes().end());
-        kv.second->shapes().clear();
+        shapes_.splice(shapes_.end(), kv.second->shapes());
     }
     return all_true;
 }
@@ -627,9 +726,7 @@ bool SimControl::run_interaction_detection() {
     };
 
     auto handle_shapes = [&](auto ent_inter) {
-        shapes_[0].insert(shapes_[0].end(), ent_inter->shapes().begin(),
-                          ent_inter->shapes().end());
-        ent_inter->shapes().clear();
+        shapes_.splice(shapes_.end(), ent_inter->shapes());
     };
 
     br::for_each(ent_inters_, run_callbacks);
@@ -641,7 +738,7 @@ bool SimControl::run_interaction_detection() {
         if (!ent->is_alive() && ent->posthumous(this->t())) {
             int id = ent->id().id();
 
-            auto msg = std::make_shared<Message<sm::EntityRemoved>>();
+            auto msg = pub_ent_rm_->make_msg<sm::EntityRemoved>();
             msg->data.set_entity_id(id);
             pub_ent_rm_->publish(msg);
 
@@ -665,18 +762,61 @@ bool SimControl::run_metrics() {
     return std::all_of(metrics_.begin(), metrics_.end(), run_metric);
 }
 
-bool SimControl::run_logging() {
-    contacts_mutex_.lock();
-    outgoing_interface_->send_frame(t_ + dt_, contacts_);
-    contacts_mutex_.unlock();
+bool SimControl::run_logging(bool last_frame) {
+    std::lock_guard<std::mutex> lock(contacts_mutex_);
+    const double t = t_ + dt_;
+
+    bool save = true;
+    if (frame_log_policy_.enabled()) {
+        run_callbacks(sim_plugin_); // collect the events sent this step
+        save = frame_log_policy_.update(t, *contacts_, last_frame);
+        if (save) {
+            // The frames kept from before an event were displayed at their
+            // own step, so they are only saved
+            std::vector<FrameSnapshot> frames = frame_log_policy_.take_buffered_frames();
+            for (FrameSnapshot &frame : frames) {
+                save_frame(frame);
+            }
+            frame_log_policy_.recycle_frames(frames);
+        } else {
+            // Only the contacts are copied, the frame is built if it is
+            // logged (by the logging thread when there is one)
+            if (frame_log_policy_.buffering()) frame_log_policy_.buffer_frame(t, *contacts_);
+
+            // the GUI still shows every frame
+            if (!enable_gui()) return true;
+        }
+    }
+
+    // When there is a logging thread every frame goes through it, so the
+    // GUI gets each frame once and in time order
+    if (frame_logger_.running()) {
+        frame_logger_.log_frame(t, *contacts_, save, true);
+    } else if (save) {
+        outgoing_interface_->send_frame(t, contacts_);
+    } else {
+        std::shared_ptr<scrimmage_proto::Frame> frame = create_frame(t, contacts_);
+        outgoing_interface_->display_frame(frame);
+    }
     return true;
 }
 
+void SimControl::save_frame(FrameSnapshot &snapshot) {
+    snapshot.display = false;
+    if (frame_logger_.running()) {
+        frame_logger_.log_frame(snapshot);
+    } else {
+        std::shared_ptr<scrimmage_proto::Frame> frame = snapshot.to_frame();
+        outgoing_interface_->save_frame(frame);
+    }
+}
+
 void SimControl::run_remove_inactive() {
     auto it = ents_.begin();
     while (it != ents_.end()) {
         if (!(*it)->active()) {
             int id = (*it)->id().id();
+            rtree_->remove((*it)->id());
             (*it)->close(t());
             it = ents_.erase(it);
             contacts_mutex_.lock();
@@ -712,6 +852,10 @@ bool SimControl::run_single_step(int loop_number) {
         return false;
     }
 
+    // The neighbor lists were found at the positions before the entities
+    // moved, so the interactions, networks and metrics query the tree
+    rtree_->invalidate_neighbor_lists();
+
     if (!run_interaction_detection()) {
         auto msg = std::make_shared<Message<sm::EntityInteractionExit>>();
         pub_ent_int_exit_->publish(msg);
@@ -806,11 +950,7 @@ void SimControl::run() {
 
 void SimControl::cleanup() {
     if (use_entity_threads_) {
-        entity_pool_stop_ = true;
-        entity_pool_condition_var_.notify_all();
-        for (std::thread &t : entity_worker_threads_) {
-            t.join();
-        }
+        scheduler_.stop();
     }
 
     // account for last step
@@ -832,7 +972,8 @@ void SimControl::cleanup() {
         kv.second->close(t());
     }
 
-    run_logging();
+    run_logging(true);
+    frame_logger_.stop();
 
     if (display_progress_) cout << endl;
 
@@ -840,6 +981,7 @@ void SimControl::cleanup() {
 }
 
 void SimControl::close() {
+    frame_logger_.stop();
     id_to_ent_map_ = nullptr;
     incoming_interface_ = nullptr;
     outgoing_interface_ = nullptr;
@@ -849,7 +991,9 @@ void SimControl::close() {
     shapes_.clear();
     contact_visuals_.clear();
     time_ = nullptr;
-    entity_pool_queue_.clear();
+    ent_vec_.clear();
+    ent_shapes_.clear();
+    thread_shapes_.clear();
     log_ = nullptr;
     random_ = nullptr;
     plugin_manager_ = nullptr;
@@ -858,11 +1002,11 @@ void SimControl::close() {
     ent_inters_.clear();
     metrics_.clear();
     networks_->clear();
-    pubsub_->pubs().clear();
-    pubsub_->subs().clear();
+    pubsub_->clear();
     pubsub_ = nullptr;
     file_search_ = nullptr;
     rtree_ = nullptr;
+    state_store_ = nullptr;
     sim_plugin_->close(t());
     pub_end_time_ = nullptr;
     pub_ent_gen_ = nullptr;
@@ -1054,13 +1198,14 @@ bool SimControl::finished() {
     return status;
 }
 
-void SimControl::get_contacts(std::unordered_map<int, Contact> &contacts) {
-    // The Viewer GUI also looks at the contacts
+void SimControl::get_contacts(ContactMap &contacts) {
+    // The Viewer GUI also looks at the contacts. The properties are shared
+    // with the simulation's contacts, but the states are copied so they don't
+    // change underneath the caller.
     contacts_mutex_.lock();
     contacts = *contacts_;
     for (auto &kv : contacts) {
-        sc::State state = *kv.second.state();
-        *kv.second.state() = state;
+        kv.second.state() = std::make_shared<State>(*kv.second.state());
     }
     contacts_mutex_.unlock();
 }
@@ -1170,74 +1315,98 @@ bool SimControl::single_step() {
     return value;
 }
 
-void SimControl::worker() {
-    while (true) {
-        entity_pool_mutex_.lock();
-        entity_pool_condition_var_.wait(entity_pool_mutex_);
-        entity_pool_mutex_.unlock();
+void print_err(PluginPtr p) {
+    if (p->print_err_on_exit) {
+        std::cout << "failed to update entity " << p->parent()->id().id()
+            << ", plugin type \"" << p->type() << "\""
+            << ", plugin name \"" << p->name() << "\"" << std::endl;
+    }
+}
 
-        if (entity_pool_stop_) {
-            break;
+bool SimControl::run_entity_tasks(const std::string &phase, EntityTaskFunc func) {
+    auto run_range = [&](size_t begin, size_t end, int /*thread_id*/) {
+        bool success = true;
+        for (size_t i = begin; i < end; i++) {
+            success &= func(ent_vec_[i], ent_shapes_[i]);
         }
+        return success;
+    };
+    return scheduler_.run(phase, ent_vec_.size(), run_range);
+}
 
-        while (true) {
-            entity_pool_mutex_.lock();
-            if (entity_pool_queue_.empty()) {
-                entity_pool_mutex_.unlock();
-                break;
+bool SimControl::run_post_motion(size_t begin, size_t end, int thread_id) {
+    auto &out = thread_shapes_[thread_id];
+    for (size_t i = begin; i < end; i++) {
+        EntityPtr &ent = ent_vec_[i];
+        br::for_each(ent->sensors() | ba::map_values, run_callbacks);
+
+        ent->setup_desired_state();
+
+        for (AutonomyPtr &autonomy : ent->autonomies()) {
+            if (autonomy->need_reset()) {
+                autonomy->set_state(ent->motion()->state());
             }
-            std::shared_ptr<Task> task = entity_pool_queue_.front();
-            EntityPtr ent = task->ent;
-            entity_pool_queue_.pop_front();
-            entity_pool_mutex_.unlock();
+        }
 
-            auto &autonomies = ent->autonomies();
-            br::for_each(autonomies, run_callbacks);
-            auto run = [&](auto &autonomy) {return autonomy->step_autonomy(t_, dt_);};
-            bool success = std::all_of(autonomies.begin(), autonomies.end(), run);
+        // controller and motion model shapes come before autonomy shapes
+        for (ShapePtr &shape : ent_shapes_[i]) {
+            out.emplace_back(i, shape);
+        }
+        ent_shapes_[i].clear();
 
-            entity_pool_mutex_.lock();
-            task->prom.set_value(success);
-            entity_pool_mutex_.unlock();
+        for (AutonomyPtr &autonomy : ent->autonomies()) {
+            for (ShapePtr &shape : autonomy->shapes()) {
+                out.emplace_back(i, shape);
+            }
+            autonomy->shapes().clear();
         }
     }
+    return true;
 }
 
-void print_err(PluginPtr p) {
-    if (p->print_err_on_exit) {
-        std::cout << "failed to update entity " << p->parent()->id().id()
-            << ", plugin type \"" << p->type() << "\""
-            << ", plugin name \"" << p->name() << "\"" << std::endl;
+bool SimControl::run_motion(EntityPtr &ent, double t, double dt,
+                            std::list<ShapePtr> &shapes) {
+    bool success = true;
+    double motion_dt = dt / mp_->motion_multiplier();
+    double temp_t = t;
+    ControllerPtr ctrl = ent->controller();
+    MotionModelPtr &motion = ent->motion();
+
+    for (int i = 0; i < mp_->motion_multiplier(); i++) {
+        run_callbacks(ctrl);
+        if (!ctrl->step(temp_t, motion_dt)) {
+            print_err(ctrl);
+            success = false;
+        }
+        shapes.splice(shapes.end(), ctrl->shapes());
+
+        run_callbacks(motion);
+        if (!motion->step(temp_t, motion_dt)) {
+            print_err(motion);
+            success = false;
+        }
+        shapes.splice(shapes.end(), motion->shapes());
+        temp_t += motion_dt;
     }
+    return success;
 }
 
 bool SimControl::run_entities() {
     contacts_mutex_.lock();
     bool success = true;
 
+    ent_vec_.assign(ents_.begin(), ents_.end());
+    ent_shapes_.resize(ent_vec_.size());
+
     // run autonomies threaded or in a single thread
     if (use_entity_threads_) {
-
-        // put tasks on queue
-        std::vector<std::future<bool>> futures;
-        futures.reserve(ents_.size());
-
-        entity_pool_mutex_.lock();
-        for (EntityPtr &ent : ents_) {
-            std::shared_ptr<Task> task = std::make_shared<Task>();
-            task->ent = ent;
-            entity_pool_queue_.push_back(task);
-            futures.push_back(task->prom.get_future());
-        }
-        entity_pool_mutex_.unlock();
-
-        // tell the threads to run
-        entity_pool_condition_var_.notify_all();
-
-        // wait for results
-        for (std::future<bool> &future : futures) {
-            success &= future.get();
-        }
+        auto run_autonomies = [&](EntityPtr &ent, std::list<ShapePtr> &/*shapes*/) {
+            auto &autonomies = ent->autonomies();
+            br::for_each(autonomies, run_callbacks);
+            auto run = [&](auto &autonomy) {return autonomy->step_autonomy(t_, dt_);};
+            return std::all_of(autonomies.begin(), autonomies.end(), run);
+        };
+        success &= run_entity_tasks("autonomy", run_autonomies);
     } else {
 
         for (EntityPtr &ent : ents_) {
@@ -1253,70 +1422,64 @@ bool SimControl::run_entities() {
         }
     }
 
-    double motion_dt = dt_ / mp_->motion_multiplier();
-    double temp_t = t_;
-    for (int i = 0; i < mp_->motion_multiplier(); i++) {
-        // Run each entity's controllers
-        for (EntityPtr &ent : ents_) {
-            std::list<ShapePtr> &shapes = shapes_[ent->id().id()];
-            ControllerPtr ctrl = ent->controller();
-
-            // Execute callbacks for received messages before calling
-            // controllers
-            run_callbacks(ctrl);
-            if (!ctrl->step(temp_t, motion_dt)) {
-                print_err(ctrl);
-                success = false;
-            }
-            shapes.insert(shapes.end(), ctrl->shapes().begin(),
-                          ctrl->shapes().end());
-            ctrl->shapes().clear();
-        }
+    if (use_entity_threads_ && parallel_motion_) {
+        // Each entity's controller and motion model only depend on the
+        // entity's own state, so the whole chain (including every
+        // motion_multiplier sub-step) runs as a single task per entity.
+        auto run_ent_motion = [&](EntityPtr &ent, std::list<ShapePtr> &shapes) {
+            return run_motion(ent, t_, dt_, shapes);
+        };
+        success &= run_entity_tasks("motion", run_ent_motion);
+    } else {
+        double motion_dt = dt_ / mp_->motion_multiplier();
+        double temp_t = t_;
+        for (int i = 0; i < mp_->motion_multiplier(); i++) {
+            // Run each entity's controllers
+            for (size_t j = 0; j < ent_vec_.size(); j++) {
+                EntityPtr &ent = ent_vec_[j];
+                std::list<ShapePtr> &shapes = ent_shapes_[j];
+                ControllerPtr ctrl = ent->controller();
 
-        // Run each entity's motion model
-        for (EntityPtr &ent : ents_) {
-            auto &shapes = shapes_[ent->id().id()];
-
-            // Execute callbacks for received messages before calling
-            // motion models
-            run_callbacks(ent->motion());
-            if (!ent->motion()->step(temp_t, motion_dt)) {
-                print_err(ent->motion());
-                success = false;
+                // Execute callbacks for received messages before calling
+                // controllers
+                run_callbacks(ctrl);
+                if (!ctrl->step(temp_t, motion_dt)) {
+                    print_err(ctrl);
+                    success = false;
+                }
+                shapes.splice(shapes.end(), ctrl->shapes());
             }
-            shapes.insert(shapes.end(), ent->motion()->shapes().begin(),
-                          ent->motion()->shapes().end());
-            ent->motion()->shapes().clear();
-        }
-        temp_t += motion_dt;
-    }
-
-    for (EntityPtr &ent : ents_) {
-        br::for_each(ent->sensors() | ba::map_values, run_callbacks);
-    }
 
-    for (EntityPtr &ent : ents_) {
-        ent->setup_desired_state();
-    }
+            // Run each entity's motion model
+            for (size_t j = 0; j < ent_vec_.size(); j++) {
+                EntityPtr &ent = ent_vec_[j];
+                std::list<ShapePtr> &shapes = ent_shapes_[j];
 
-    for (EntityPtr &ent : ents_) {
-        for (AutonomyPtr &autonomy : ent->autonomies()) {
-            if (autonomy->need_reset()) {
-                autonomy->set_state(ent->motion()->state());
+                // Execute callbacks for received messages before calling
+                // motion models
+                run_callbacks(ent->motion());
+                if (!ent->motion()->step(temp_t, motion_dt)) {
+                    print_err(ent->motion());
+                    success = false;
+                }
+                shapes.splice(shapes.end(), ent->motion()->shapes());
             }
+            temp_t += motion_dt;
         }
     }
 
-    contacts_mutex_.unlock();
-
-    for (EntityPtr &ent : ents_) {
-        auto &shapes = shapes_[ent->id().id()];
-        for (AutonomyPtr &autonomy : ent->autonomies()) {
-            shapes.insert(shapes.end(), autonomy->shapes().begin(),
-                          autonomy->shapes().end());
-            autonomy->shapes().clear();
-        }
+    // Sensor callbacks, desired state, autonomy resets and shape collection
+    // only touch the entity itself, so they are fused into a single pass.
+    auto post_motion = [&](size_t begin, size_t end, int thread_id) {
+        return run_post_motion(begin, end, thread_id);
+    };
+    if (use_entity_threads_) {
+        success &= scheduler_.run("post_motion", ent_vec_.size(), post_motion);
+    } else {
+        success &= run_post_motion(0, ent_vec_.size(), 0);
     }
+
+    contacts_mutex_.unlock();
     return success;
 }
 
@@ -1324,14 +1487,30 @@ void SimControl::run_send_shapes() {
     // Convert map of shapes to sp::Shapes type
     scrimmage_proto::Shapes shapes;
     shapes.set_time(this->t());
-    for (auto &kv : shapes_) {
-        for (auto &shape : kv.second) {
-            scrimmage_proto::Shape *s = shapes.add_shape();
-            *s = *shape;
-        }
+    for (auto &shape : shapes_) {
+        *shapes.add_shape() = *shape;
     }
-    outgoing_interface_->send_shapes(shapes);
     shapes_.clear();
+
+    // Entity shapes were collected per thread. Sorting by entity index
+    // restores the single threaded order so the shapes log doesn't depend
+    // on how the chunks were scheduled.
+    auto &ent_shapes = thread_shapes_[0];
+    for (size_t i = 1; i < thread_shapes_.size(); i++) {
+        ent_shapes.insert(ent_shapes.end(), thread_shapes_[i].begin(),
+                          thread_shapes_[i].end());
+        thread_shapes_[i].clear();
+    }
+    if (thread_shapes_.size() > 1) {
+        auto cmp = [](auto &a, auto &b) {return a.first < b.first;};
+        std::stable_sort(ent_shapes.begin(), ent_shapes.end(), cmp);
+    }
+    for (auto &kv : ent_shapes) {
+        *shapes.add_shape() = *kv.second;
+    }
+    ent_shapes.clear();
+
+    outgoing_interface_->send_shapes(shapes);
 }
 
 void SimControl::run_send_contact_visuals() {
@@ -1351,10 +1530,75 @@ bool SimControl::output_runtime() {
     double sim_t = time_->t();
     runtime_file << "wall: " << t << std::endl;
     runtime_file << "sim: " << sim_t << std::endl;
+    for (auto &kv : scheduler_.phase_stats()) {
+        runtime_file << "speedup_" << kv.first << ": "
+            << kv.second.speedup() << std::endl;
+    }
+    runtime_file << "rtree: " << rtree_time_ << std::endl;
+    if (incremental_rtree_) {
+        const RTree::UpdateStats &stats = rtree_->update_stats();
+        runtime_file << "rtree_rebuilds: " << stats.rebuilds << std::endl;
+        runtime_file << "rtree_rebuild_time: " << stats.rebuild_time << std::endl;
+        runtime_file << "rtree_updates: " << stats.updates << std::endl;
+        runtime_file << "rtree_update_time: " << stats.update_time << std::endl;
+        runtime_file << "rtree_moved: " << stats.moved << std::endl;
+    }
+    if (neighbor_lists_) {
+        runtime_file << "neighbor_lists: " << neighbor_lists_time_ << std::endl;
+    }
+    if (get("async_logging", mp_->params(), false)) {
+        const FrameLogger::Stats &stats = frame_logger_.stats();
+        runtime_file << "logged_frames: " << stats.frames << std::endl;
+        runtime_file << "dropped_frames: " << stats.dropped << std::endl;
+        runtime_file << "decimated_frames: " << stats.decimated << std::endl;
+        runtime_file << "failed_frames: " << stats.failed << std::endl;
+        runtime_file << "logging_wait: " << stats.wait_time << std::endl;
+    }
+    if (frame_log_policy_.enabled()) {
+        const FrameLogPolicy::Stats &stats = frame_log_policy_.stats();
+        runtime_file << "policy_logged_frames: " << stats.logged << std::endl;
+        runtime_file << "policy_skipped_frames: "
+                     << stats.frames - stats.logged << std::endl;
+    }
     runtime_file.close();
     return true;
 }
 
+void SimControl::collect_pubsub_stats(bool collect) {
+    pubsub_->collect_stats(collect);
+}
+
+bool SimControl::output_pubsub_stats() {
+    std::string out_file = mp_->log_dir() + "/pubsub_stats.csv";
+    std::ofstream stats_file(out_file);
+    if (!stats_file.is_open()) {
+        std::cout << "could not open " << out_file
+                  << " for writing pubsub stats" << std::endl;
+        return false;
+    }
+
+    stats_file << "network,topic,num_pubs,num_subs,"
+        << "published,published_bytes,pub_dropped,pub_max_queue,"
+        << "delivered,delivered_bytes,sub_dropped,sub_max_queue,"
+        << "callback_seconds,callback_p99_us,"
+        << "latency_mean,latency_p99" << std::endl;
+    for (const TopicStats &s : pubsub_->topic_stats()) {
+        double latency_mean = s.subs.msgs == 0 ? 0 : s.subs.latency_sum / s.subs.msgs;
+        stats_file << s.network << "," << s.topic << ","
+            << s.num_pubs << "," << s.num_subs << ","
+            << s.pubs.msgs << "," << s.pubs.bytes << ","
+            << s.pubs.dropped << "," << s.pubs.max_queue_depth << ","
+            << s.subs.msgs << "," << s.subs.bytes << ","
+            << s.subs.dropped << "," << s.subs.max_queue_depth << ","
+            << s.subs.callback_ns / 1e9 << ","
+            << s.subs.callback_time_ns.quantile(0.99) / 1e3 << ","
+            << latency_mean << ","
+            << s.subs.latency_us.quantile(0.99) / 1e6 << std::endl;
+    }
+    stats_file.close();
+    return true;
+}
+
 bool SimControl::output_summary() {
     std::map<int, double> team_scores;
     std::map<int, std::map<std::string, double>> team_metrics;
@@ -1445,6 +1689,8 @@ void SimControl::set_limited_verbosity(bool limited_verbosity) {
     limited_verbosity_ = limited_verbosity;
 }
 
+TaskScheduler &SimControl::scheduler() {return scheduler_;}
+
 InterfacePtr SimControl::incoming_interface() {return incoming_interface_;}
 InterfacePtr SimControl::outgoing_interface() {return outgoing_interface_;}
 std::list<EntityPtr> &SimControl::ents() {return ents_;}
@@ -31,6 +31,7 @@
  */
 
 #include <scrimmage/common/FileSearch.h>
+#include <scrimmage/common/Time.h>
 #include <scrimmage/common/Utilities.h>
 #include <scrimmage/entity/Entity.h>
 #include <scrimmage/log/Log.h>
@@ -40,10 +41,14 @@
 #include <scrimmage/parse/ConfigParse.h>
 #include <scrimmage/parse/ParseUtils.h>
 #include <scrimmage/plugin_manager/PluginManager.h>
+#include <scrimmage/pubsub/MessageQueue.h>
 #include <scrimmage/simcontrol/EntityInteraction.h>
 #include <scrimmage/simcontrol/SimControl.h>
 #include <scrimmage/simcontrol/SimUtils.h>
 
+#include <algorithm>
+#include <chrono> // NOLINT
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 
@@ -147,12 +152,43 @@ bool create_metrics(const SimUtilsInfo &info, std::list<MetricsPtr> &metrics_lis
     return true;
 }
 
-void run_callbacks(PluginPtr plugin) {
+void run_callbacks(const PluginPtr &plugin) {
+    // Only plugins that were sent messages since their callbacks last ran
+    // have anything to do. A message that arrives while the callbacks run
+    // sets the flag again and is handled now or on the next call.
+    if (!plugin->take_pending_msgs()) {
+        return;
+    }
+
+    // reuse the queue's storage across plugins run by this thread
+    thread_local MessageQueue msgs;
+    const std::shared_ptr<const Time> &time = plugin->get_time();
     for (auto &sub : plugin->subs()) {
-        for (auto msg : sub->pop_msgs<MessageBase>()) {
-            sub->accept(msg);
+        if (!sub->has_msgs()) {
+            continue;
+        }
+        sub->pop_msgs(msgs);
+        NetworkDeviceStats &stats = sub->stats();
+
+        // the sim time between a message being sent and handled
+        if (time) {
+            for (size_t i = 0; i < msgs.size(); i++) {
+                double latency = std::max(0.0, time->t() - msgs[i]->time);
+                stats.latency_sum += latency;
+                stats.latency_us.add(std::llround(latency * 1e6));
+            }
         }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < msgs.size(); i++) {
+            sub->accept(msgs[i]);
+        }
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        stats.callback_ns += ns;
+        stats.callback_time_ns.add(ns);
     }
+    msgs.clear();
 }
 
 bool verify_io_connection(VariableIO &output, VariableIO &input) {
@@ -254,11 +290,13 @@ std::shared_ptr<Log> preprocess_scrimmage(
     bool output_git = logging_logic(mp, "git_commits");
     bool output_mission = logging_logic(mp, "mission");
     bool output_seed = logging_logic(mp, "seed");
+    bool output_pubsub = logging_logic(mp, "pubsub");
     bool output_nothing =
         !output_all && !output_frames && !output_summary &&
-        !output_git && !output_mission && !output_seed;
+        !output_git && !output_mission && !output_seed && !output_pubsub;
 
     simcontrol.set_limited_verbosity(output_nothing);
+    simcontrol.collect_pubsub_stats(output_pubsub);
 
     if (!output_nothing) {
         mp->create_log_dir();
@@ -300,10 +338,12 @@ boost::optional<std::string> postprocess_scrimmage(
     bool output_git = logging_logic(mp, "git_commits");
     bool output_mission = logging_logic(mp, "mission");
     bool output_seed = logging_logic(mp, "seed");
+    bool output_pubsub = logging_logic(mp, "pubsub");
     bool output_nothing =
         !output_all && !output_frames && !output_summary &&
-        !output_git && !output_mission && !output_seed;
+        !output_git && !output_mission && !output_seed && !output_pubsub;
     if (output_summary && !simcontrol.output_summary()) return boost::none;
+    if (output_pubsub && !simcontrol.output_pubsub_stats()) return boost::none;
 
     if (output_git) {
         std::map<std::string, std::unordered_set<std::string>> commits =
@@ -355,6 +395,16 @@ std::shared_ptr<Log> setup_logging(MissionParsePtr mp) {
     if (check_output(output_type, "frames")) {
         log->set_enable_log(true);
         log->init(mp->log_dir(), Log::WRITE);
+        if (get("columnar_frames", mp->params(), false)) {
+            auto &attr = mp->attributes()["columnar_frames"];
+            log->enable_columnar_frames(get("chunk_duration", attr, 10.0));
+        }
+        if (get("compressed_frames", mp->params(), false)) {
+            auto &attr = mp->attributes()["compressed_frames"];
+            log->enable_compressed_frames(
+                get<unsigned int>("keyframe_interval", attr, 100),
+                get("quantum", attr, 0.0), get("quat_quantum", attr, 1.0e-6));
+        }
     } else {
         log->set_enable_log(false);
         log->init(mp->log_dir(), Log::NONE);
@@ -0,0 +1,161 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/log/ColumnarLog.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace sc = scrimmage;
+namespace sp = scrimmage_proto;
+
+namespace {
+sp::Frame make_frame(double t, int num_contacts) {
+    sp::Frame frame;
+    frame.set_time(t);
+    for (int i = 0; i < num_contacts; i++) {
+        sp::Contact *c = frame.add_contact();
+        c->mutable_id()->set_id(i + 1);
+        c->mutable_id()->set_team_id(i % 2);
+        c->set_type(sp::QUADROTOR);
+        c->set_active(i != 0);
+        c->mutable_state()->mutable_position()->set_x(t * 10 + i);
+        c->mutable_state()->mutable_velocity()->set_y(-i);
+        c->mutable_state()->mutable_orientation()->set_w(1);
+    }
+    return frame;
+}
+} // namespace
+
+TEST(test_columnar_log, round_trip) {
+    std::string filename = testing::TempDir() + "test_columnar_log.col";
+    sc::ColumnarLogWriter writer;
+    ASSERT_TRUE(writer.open(filename, 1.0));
+    for (int i = 0; i < 35; i++) {
+        // the number of contacts changes over time
+        ASSERT_TRUE(writer.write_frame(make_frame(i * 0.1, 1 + i % 4)));
+    }
+    ASSERT_TRUE(writer.close());
+
+    sc::ColumnarLogReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    ASSERT_EQ(reader.chunks().size(), 4u);
+    EXPECT_EQ(reader.chunks()[0].num_frames, 10u);
+    EXPECT_EQ(reader.chunks()[3].num_frames, 5u);
+    EXPECT_DOUBLE_EQ(reader.chunks()[1].t_begin, 1.0);
+
+    EXPECT_EQ(reader.find_chunk(0), 0u);
+    EXPECT_EQ(reader.find_chunk(1.95), 2u);
+    EXPECT_EQ(reader.find_chunk(100), 4u);
+
+    // a frame read by time is the same as the frame that was written
+    auto frame = reader.read_frame(2.25);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->SerializeAsString(), make_frame(23 * 0.1, 4).SerializeAsString());
+    EXPECT_EQ(reader.read_frame(100), nullptr);
+
+    // a single column can be read on its own
+    std::vector<double> pos_x;
+    ASSERT_TRUE(reader.read_column(3, sc::ColumnarChunk::POS_X, pos_x));
+    EXPECT_EQ(pos_x.size(), reader.chunks()[3].num_rows);
+    EXPECT_DOUBLE_EQ(pos_x[0], 30);
+    std::vector<int32_t> wrong_type;
+    EXPECT_FALSE(reader.read_column(3, sc::ColumnarChunk::POS_X, wrong_type));
+
+    std::remove(filename.c_str());
+}
+
+TEST(test_columnar_log, unclosed) {
+    std::string filename = testing::TempDir() + "test_columnar_log_unclosed.col";
+    std::string copy = testing::TempDir() + "test_columnar_log_crashed.col";
+    sc::ColumnarLogWriter writer;
+    ASSERT_TRUE(writer.open(filename, 1.0));
+    for (int i = 0; i < 35; i++) {
+        ASSERT_TRUE(writer.write_frame(make_frame(i * 0.1, 1 + i % 4)));
+    }
+
+    // Copy the log as a crashed run would leave it: the written chunks, part
+    // of the next one and no index
+    std::ifstream in(filename, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream out(copy, std::ios::binary);
+    out << data << std::string(20, '\x01');
+    out.close();
+    ASSERT_TRUE(writer.close());
+
+    // the index is rebuilt from the chunk footers
+    sc::ColumnarLogReader reader;
+    ASSERT_TRUE(reader.open(copy));
+    ASSERT_EQ(reader.chunks().size(), 3u);
+    EXPECT_DOUBLE_EQ(reader.chunks()[2].t_begin, 2.0);
+    auto frame = reader.read_frame(2.25);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->SerializeAsString(), make_frame(23 * 0.1, 4).SerializeAsString());
+    EXPECT_EQ(reader.read_frame(3.05), nullptr);
+
+    std::remove(filename.c_str());
+    std::remove(copy.c_str());
+}
+
+TEST(test_columnar_log, corrupt_trailer) {
+    std::string filename = testing::TempDir() + "test_columnar_log_trailer.col";
+    sc::ColumnarLogWriter writer;
+    ASSERT_TRUE(writer.open(filename, 1.0));
+    for (int i = 0; i < 35; i++) {
+        ASSERT_TRUE(writer.write_frame(make_frame(i * 0.1, 1 + i % 4)));
+    }
+    ASSERT_TRUE(writer.close());
+
+    // The trailer is the index offset, the number of chunks and a magic
+    // number. Give it a chunk count that doesn't fit in the file.
+    for (uint64_t num_chunks : {uint64_t(1) << 40, uint64_t(5)}) {
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-16, std::ios::end);
+        file.write(reinterpret_cast<const char *>(&num_chunks), sizeof(num_chunks));
+        file.close();
+
+        // the index is rebuilt from the chunk footers instead
+        sc::ColumnarLogReader reader;
+        ASSERT_TRUE(reader.open(filename));
+        ASSERT_EQ(reader.chunks().size(), 4u);
+        auto frame = reader.read_frame(3.35);
+        ASSERT_NE(frame, nullptr);
+        EXPECT_EQ(frame->SerializeAsString(), make_frame(34 * 0.1, 3).SerializeAsString());
+    }
+
+    std::remove(filename.c_str());
+}
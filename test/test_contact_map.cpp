@@ -0,0 +1,112 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/common/ID.h>
+#include <scrimmage/entity/Contact.h>
+#include <scrimmage/math/State.h>
+
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace sc = scrimmage;
+
+TEST(test_contact_map, lookup) {
+    sc::ContactMap contacts;
+    for (int id : {3, 1, 2, -5}) {
+        contacts[id].set_id(sc::ID(id, 0, 1));
+        contacts[id].state()->pos() << id, 0, 0;
+    }
+    EXPECT_EQ(contacts.size(), 4u);
+    EXPECT_EQ(contacts.count(2), 1u);
+    EXPECT_EQ(contacts.count(4), 0u);
+    EXPECT_EQ(contacts.at(-5).id().id(), -5);
+    EXPECT_THROW(contacts.at(4), std::out_of_range);
+    EXPECT_TRUE(contacts.find(4) == contacts.end());
+    EXPECT_EQ(contacts.find(3)->second.state()->pos()(0), 3);
+
+    // iteration is in slot order, i.e., insertion order
+    std::vector<int> ids;
+    for (auto &kv : contacts) {
+        EXPECT_EQ(kv.first, kv.second.id().id());
+        ids.push_back(kv.first);
+    }
+    EXPECT_EQ(ids, std::vector<int>({3, 1, 2, -5}));
+}
+
+TEST(test_contact_map, erase) {
+    sc::ContactMap contacts;
+    for (int id = 1; id <= 5; id++) {
+        contacts[id].set_id(sc::ID(id, 0, 1));
+    }
+
+    sc::ContactMap::Handle h = contacts.handle(2);
+    EXPECT_EQ(contacts.get(h), &contacts.at(2));
+
+    EXPECT_EQ(contacts.erase(2), 1u);
+    EXPECT_EQ(contacts.erase(2), 0u);
+    EXPECT_EQ(contacts.size(), 4u);
+    EXPECT_EQ(contacts.get(h), nullptr);
+
+    // erasing while iterating
+    for (auto it = contacts.begin(); it != contacts.end();) {
+        it = it->first == 4 ? contacts.erase(it) : std::next(it);
+    }
+
+    std::set<int> ids;
+    for (auto &kv : contacts) ids.insert(kv.first);
+    EXPECT_EQ(ids, std::set<int>({1, 3, 5}));
+
+    // the freed slot is reused, but old handles stay invalid
+    contacts[7].set_id(sc::ID(7, 0, 1));
+    EXPECT_EQ(contacts.num_slots(), 5);
+    EXPECT_EQ(contacts.get(h), nullptr);
+    EXPECT_NE(contacts.get(contacts.handle(7)), nullptr);
+}
+
+TEST(test_contact_map, copy) {
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+
+    sc::ContactMap copy = contacts;
+    copy.erase(1);
+    copy[2].set_id(sc::ID(2, 0, 1));
+    EXPECT_EQ(contacts.size(), 1u);
+    EXPECT_EQ(contacts.count(1), 1u);
+    EXPECT_EQ(contacts.count(2), 0u);
+
+    contacts.clear();
+    EXPECT_TRUE(contacts.empty());
+    EXPECT_TRUE(contacts.begin() == contacts.end());
+}
@@ -0,0 +1,171 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+
+#include <gtest/gtest.h>
+#include <scrimmage/plugins/metrics/CPA/CPA.h>
+#include <scrimmage/entity/Entity.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/parse/MissionParse.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <Eigen/Dense>
+
+#include <boost/filesystem.hpp>
+
+namespace sc = scrimmage;
+namespace fs = boost::filesystem;
+
+namespace {
+class TestCPA : public sc::metrics::CPA {
+ public:
+    std::map<int, sc::metrics::CPAData> &cpa() { return cpa_map_; }
+};
+
+using EntityMap = std::unordered_map<int, sc::EntityPtr>;
+
+std::shared_ptr<EntityMap> make_entities(const std::map<int, Eigen::Vector3d> &positions) {
+    auto mp = std::make_shared<sc::MissionParse>();
+    mp->set_log_dir(fs::temp_directory_path().string());
+
+    auto ents = std::make_shared<EntityMap>();
+    for (auto &kv : positions) {
+        auto ent = std::make_shared<sc::Entity>();
+        ent->set_mp(mp);
+        ent->state() = std::make_shared<sc::State>();
+        ent->state()->pos() = kv.second;
+        (*ents)[kv.first] = ent;
+    }
+    return ents;
+}
+
+void move(EntityMap &ents, const std::map<int, Eigen::Vector3d> &positions) {
+    for (auto &kv : positions) {
+        ents.at(kv.first)->state()->pos() = kv.second;
+    }
+}
+
+std::shared_ptr<TestCPA> make_cpa(const std::shared_ptr<EntityMap> &ents,
+                                  bool continuous) {
+    auto cpa = std::make_shared<TestCPA>();
+    std::map<std::string, std::string> params {
+        {"continuous", continuous ? "true" : "false"}};
+    cpa->init(params);
+    cpa->set_id_to_ent_map(ents);
+    return cpa;
+}
+
+// Entity 1 is at the origin, the others are at the given x coordinates
+std::shared_ptr<TestCPA> run_cpa(const std::map<int, double> &xs) {
+    std::map<int, Eigen::Vector3d> positions;
+    positions[1] = Eigen::Vector3d::Zero();
+    for (auto &kv : xs) {
+        positions[kv.first] = Eigen::Vector3d(kv.second, 0, 0);
+    }
+
+    auto cpa = make_cpa(make_entities(positions), false);
+    cpa->step_metrics(0, 0.1);
+    return cpa;
+}
+} // namespace
+
+TEST(test_cpa, equidistant_entities) {
+    // The entities are found in spatial hash order, but the one with the
+    // lowest id is the closest entity whichever side it is on
+    for (double x2 : {-10.0, 10.0}) {
+        auto cpa = run_cpa({{2, x2}, {3, -x2}});
+        sc::metrics::CPAData &data = cpa->cpa()[1];
+        EXPECT_DOUBLE_EQ(data.distance(), 10);
+        EXPECT_EQ(data.closest_entity(), 2);
+    }
+
+    auto cpa = run_cpa({{2, 10.0}, {3, 9.0}});
+    EXPECT_EQ(cpa->cpa()[1].closest_entity(), 3);
+    EXPECT_EQ(cpa->cpa()[2].closest_entity(), 3);
+}
+
+TEST(test_cpa, continuous_crossing) {
+    // The entities swap sides between steps, passing through each other
+    // halfway through the step
+    auto ents = make_entities({{1, {-5, 0, 0}}, {2, {5, 0, 0}}});
+    auto cpa = make_cpa(ents, true);
+    cpa->step_metrics(9, 1);
+    EXPECT_DOUBLE_EQ(cpa->cpa()[1].distance(), 10);
+
+    move(*ents, {{1, {5, 0, 0}}, {2, {-5, 0, 0}}});
+    cpa->step_metrics(10, 1);
+    for (int id : {1, 2}) {
+        sc::metrics::CPAData &data = cpa->cpa()[id];
+        EXPECT_NEAR(data.distance(), 0, 1e-9);
+        EXPECT_EQ(data.closest_entity(), 3 - id);
+        EXPECT_DOUBLE_EQ(data.time(), 9.5);
+    }
+}
+
+TEST(test_cpa, continuous_fast_entity) {
+    // Entity 3 ends the step far outside entity 1's CPA with entity 2, but
+    // passes within 1 of it on the way
+    auto ents = make_entities({{1, {0, 0, 0}}, {2, {2, 0, 0}}, {3, {-100, 1, 0}}});
+    auto cpa = make_cpa(ents, true);
+    cpa->step_metrics(0, 1);
+    EXPECT_DOUBLE_EQ(cpa->cpa()[1].distance(), 2);
+    EXPECT_EQ(cpa->cpa()[1].closest_entity(), 2);
+
+    move(*ents, {{3, {100, 1, 0}}});
+    cpa->step_metrics(1, 1);
+    sc::metrics::CPAData &data = cpa->cpa()[1];
+    EXPECT_DOUBLE_EQ(data.distance(), 1);
+    EXPECT_EQ(data.closest_entity(), 3);
+    EXPECT_DOUBLE_EQ(data.time(), 0.5);
+}
+
+TEST(test_cpa, continuous_removed_entity) {
+    auto ents = make_entities({{1, {0, 0, 0}}, {2, {10, 0, 0}}, {3, {3, 0, 0}}});
+    auto cpa = make_cpa(ents, true);
+    cpa->step_metrics(0, 1);
+    EXPECT_EQ(cpa->cpa()[1].closest_entity(), 3);
+
+    // entity 3 is removed and entity 2 moves past where it was, so entity 3
+    // keeps its CPA and no longer takes part
+    ents->at(3)->state() = nullptr;
+    move(*ents, {{2, {1, 0, 0}}});
+    cpa->step_metrics(1, 1);
+    EXPECT_DOUBLE_EQ(cpa->cpa()[1].distance(), 1);
+    EXPECT_EQ(cpa->cpa()[1].closest_entity(), 2);
+    EXPECT_DOUBLE_EQ(cpa->cpa()[3].distance(), 3);
+    EXPECT_EQ(cpa->cpa()[3].closest_entity(), 1);
+    EXPECT_DOUBLE_EQ(cpa->cpa()[3].time(), 0);
+}
@@ -0,0 +1,180 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/log/DeltaFrameLog.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace sc = scrimmage;
+namespace sp = scrimmage_proto;
+
+namespace {
+std::vector<sp::Frame> make_frames(int num_frames) {
+    std::vector<sp::Frame> frames(num_frames);
+    for (int i = 0; i < num_frames; i++) {
+        sp::Frame &frame = frames[i];
+        frame.set_time(i * 0.1);
+        // contact 3 leaves and comes back, contact 2 switches teams
+        for (int id = 1; id <= 3; id++) {
+            if (id == 3 && i % 7 == 3) continue;
+            sp::Contact *c = frame.add_contact();
+            c->mutable_id()->set_id(id);
+            c->mutable_id()->set_team_id(id == 2 && i > 12 ? 2 : 1);
+            c->set_type(sp::QUADROTOR);
+            c->set_active(true);
+            sp::State *s = c->mutable_state();
+            s->mutable_position()->set_x(std::sin(i * 0.01 + id) * 100);
+            s->mutable_position()->set_y(id * 1.5);
+            s->mutable_position()->set_z(-i * 0.3);
+            s->mutable_velocity()->set_x(std::cos(i * 0.01 + id));
+            s->mutable_velocity()->set_y(0);
+            s->mutable_velocity()->set_z(-3);
+            s->mutable_orientation()->set_w(std::cos(i * 0.005));
+            s->mutable_orientation()->set_x(0);
+            s->mutable_orientation()->set_y(0);
+            s->mutable_orientation()->set_z(std::sin(i * 0.005));
+        }
+    }
+    return frames;
+}
+} // namespace
+
+TEST(test_delta_frame_log, lossless) {
+    std::string filename = testing::TempDir() + "test_delta_frame_log.delta";
+    std::vector<sp::Frame> frames = make_frames(45);
+
+    sc::DeltaFrameWriter writer;
+    ASSERT_TRUE(writer.open(filename, 10));
+    for (const sp::Frame &frame : frames) ASSERT_TRUE(writer.write_frame(frame));
+    ASSERT_TRUE(writer.close());
+
+    // every frame decodes to exactly the frame that was written
+    sc::DeltaFrameReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    for (int pass = 0; pass < 2; pass++) {
+        size_t i = 0;
+        while (reader.next()) {
+            ASSERT_LT(i, frames.size());
+            EXPECT_EQ(reader.frame().SerializeAsString(), frames[i].SerializeAsString());
+            i++;
+        }
+        EXPECT_EQ(i, frames.size());
+        EXPECT_TRUE(reader.clean_eof());
+        reader.rewind();
+    }
+    std::remove(filename.c_str());
+}
+
+TEST(test_delta_frame_log, quantized) {
+    std::string filename = testing::TempDir() + "test_delta_frame_log_q.delta";
+    std::vector<sp::Frame> frames = make_frames(30);
+    const double quantum = 0.01;
+
+    sc::DeltaFrameWriter writer;
+    ASSERT_TRUE(writer.open(filename, 8, quantum, 1.0e-4));
+    for (const sp::Frame &frame : frames) ASSERT_TRUE(writer.write_frame(frame));
+    ASSERT_TRUE(writer.close());
+
+    sc::DeltaFrameReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    size_t i = 0;
+    while (reader.next()) {
+        const sp::Frame &a = reader.frame();
+        const sp::Frame &b = frames[i++];
+        ASSERT_EQ(a.contact_size(), b.contact_size());
+        EXPECT_EQ(a.time(), b.time());
+        for (int c = 0; c < a.contact_size(); c++) {
+            EXPECT_EQ(a.contact(c).id().id(), b.contact(c).id().id());
+            EXPECT_EQ(a.contact(c).id().team_id(), b.contact(c).id().team_id());
+            EXPECT_NEAR(a.contact(c).state().position().x(),
+                        b.contact(c).state().position().x(), quantum / 2 + 1e-12);
+            EXPECT_NEAR(a.contact(c).state().orientation().w(),
+                        b.contact(c).state().orientation().w(), 0.5e-4 + 1e-12);
+        }
+    }
+    EXPECT_EQ(i, frames.size());
+    EXPECT_TRUE(reader.clean_eof());
+
+    // a truncated file stops at the last complete block
+    std::ifstream in(filename, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream(filename, std::ios::binary) << bytes.substr(0, bytes.size() - 3);
+    ASSERT_TRUE(reader.open(filename));
+    i = 0;
+    while (reader.next()) i++;
+    EXPECT_EQ(i, 24u);
+    EXPECT_FALSE(reader.clean_eof());
+
+    std::remove(filename.c_str());
+}
+
+TEST(test_delta_frame_log, quantized_non_finite) {
+    std::string filename = testing::TempDir() + "test_delta_frame_log_nan.delta";
+    std::vector<sp::Frame> frames = make_frames(3);
+    const double inf = std::numeric_limits<double>::infinity();
+    sp::State *s = frames[1].mutable_contact(0)->mutable_state();
+    s->mutable_position()->set_x(std::numeric_limits<double>::quiet_NaN());
+    s->mutable_position()->set_y(inf);
+    s->mutable_position()->set_z(-inf);
+    s->mutable_velocity()->set_x(1.0e300);
+
+    sc::DeltaFrameWriter writer;
+    ASSERT_TRUE(writer.open(filename, 8, 0.01, 1.0e-4));
+    for (const sp::Frame &frame : frames) ASSERT_TRUE(writer.write_frame(frame));
+    ASSERT_TRUE(writer.close());
+
+    // the non-finite values come back and the frames after them are intact
+    sc::DeltaFrameReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.next());
+    const sp::State &state = reader.frame().contact(0).state();
+    EXPECT_TRUE(std::isnan(state.position().x()));
+    EXPECT_EQ(state.position().y(), inf);
+    EXPECT_EQ(state.position().z(), -inf);
+    EXPECT_TRUE(std::isfinite(state.velocity().x()));
+    EXPECT_GT(state.velocity().x(), 0);
+    ASSERT_TRUE(reader.next());
+    EXPECT_NEAR(reader.frame().contact(0).state().position().x(),
+                frames[2].contact(0).state().position().x(), 0.005 + 1e-12);
+    EXPECT_FALSE(reader.next());
+    EXPECT_TRUE(reader.clean_eof());
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,155 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+
+#include <gtest/gtest.h>
+#include <scrimmage/common/ID.h>
+#include <scrimmage/entity/Contact.h>
+#include <scrimmage/log/FrameLogPolicy.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace sc = scrimmage;
+
+TEST(test_frame_log_policy, disabled) {
+    sc::FrameLogPolicy policy;
+    EXPECT_FALSE(policy.enabled());
+    EXPECT_FALSE(policy.buffering());
+}
+
+TEST(test_frame_log_policy, rate) {
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+
+    // frames every 0.1 s logged at 2 Hz
+    sc::FrameLogPolicy policy;
+    policy.set_rate(2);
+    EXPECT_TRUE(policy.enabled());
+    std::vector<int> logged;
+    for (int i = 0; i <= 20; i++) {
+        if (policy.update(i * 0.1, contacts, i == 20)) logged.push_back(i);
+    }
+    EXPECT_EQ(logged, std::vector<int>({0, 5, 10, 15, 20}));
+    EXPECT_EQ(policy.stats().frames, 21u);
+    EXPECT_EQ(policy.stats().logged, 5u);
+
+    // a dt that doesn't divide the period logs the first frame after each
+    // multiple of it
+    sc::FrameLogPolicy policy2;
+    policy2.set_rate(1);
+    logged.clear();
+    for (int i = 0; i <= 10; i++) {
+        if (policy2.update(i * 0.3, contacts)) logged.push_back(i);
+    }
+    EXPECT_EQ(logged, std::vector<int>({0, 4, 7, 10}));
+}
+
+TEST(test_frame_log_policy, dead_band) {
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+    contacts[1].set_active(true);
+
+    sc::FrameLogPolicy policy;
+    policy.set_dead_band(1);
+    EXPECT_TRUE(policy.update(0, contacts));
+
+    // moves less than the dead band since the last logged frame
+    contacts[1].state()->pos() << 0.6, 0, 0;
+    EXPECT_FALSE(policy.update(1, contacts));
+    contacts[1].state()->pos() << 0.9, 0.3, 0;
+    EXPECT_FALSE(policy.update(2, contacts));
+    contacts[1].state()->pos() << 1.1, 0, 0;
+    EXPECT_TRUE(policy.update(3, contacts));
+    EXPECT_FALSE(policy.update(4, contacts));
+
+    // contacts that are added, removed or change state are logged
+    contacts[2].set_id(sc::ID(2, 0, 1));
+    EXPECT_TRUE(policy.update(5, contacts));
+    EXPECT_FALSE(policy.update(6, contacts));
+    contacts[1].set_active(false);
+    EXPECT_TRUE(policy.update(7, contacts));
+    contacts.erase(1);
+    EXPECT_TRUE(policy.update(8, contacts));
+    EXPECT_FALSE(policy.update(9, contacts));
+    EXPECT_TRUE(policy.update(10, contacts, true));
+}
+
+TEST(test_frame_log_policy, events) {
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+
+    sc::FrameLogPolicy policy;
+    policy.set_events_enabled(true);
+    policy.set_event_window(0.25, 0.2);
+    EXPECT_TRUE(policy.buffering());
+
+    auto step = [&](int i) {
+        const double t = i * 0.1;
+        contacts[1].state()->pos() << i, 0, 0;
+        if (policy.update(t, contacts)) return true;
+        policy.buffer_frame(t, contacts);
+        return false;
+    };
+
+    std::vector<int> logged;
+    for (int i = 0; i <= 15; i++) {
+        if (i == 10) policy.add_event(i * 0.1);
+        if (step(i)) {
+            std::vector<sc::FrameSnapshot> frames = policy.take_buffered_frames();
+            for (sc::FrameSnapshot &frame : frames) {
+                // the buffered frames hold the contacts at their own time
+                auto proto = frame.to_frame();
+                int j = static_cast<int>(std::round(proto->time() * 10));
+                ASSERT_EQ(proto->contact_size(), 1);
+                EXPECT_EQ(proto->contact(0).state().position().x(), j);
+                logged.push_back(j);
+            }
+            policy.recycle_frames(frames);
+            logged.push_back(i);
+        }
+    }
+    // the first frame, the pre window, the event and the post window
+    EXPECT_EQ(logged, std::vector<int>({0, 8, 9, 10, 11, 12}));
+    EXPECT_EQ(policy.stats().frames, 16u);
+    EXPECT_EQ(policy.stats().logged, 6u);
+
+    // events are ignored unless enabled
+    sc::FrameLogPolicy policy2;
+    policy2.set_rate(0.1);
+    EXPECT_TRUE(policy2.update(0, contacts));
+    policy2.add_event(1);
+    EXPECT_FALSE(policy2.update(1, contacts));
+}
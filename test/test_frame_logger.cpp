@@ -0,0 +1,182 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/common/ID.h>
+#include <scrimmage/entity/Contact.h>
+#include <scrimmage/log/FrameLogger.h>
+#include <scrimmage/log/Log.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/network/Interface.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <memory>
+#include <vector>
+
+namespace sc = scrimmage;
+
+namespace {
+std::shared_ptr<sc::Interface> make_interface() {
+    auto log = std::make_shared<sc::Log>();
+    log->set_enable_log(false);
+    log->init("", sc::Log::NONE);
+    auto interface = std::make_shared<sc::Interface>();
+    interface->set_log(log);
+    return interface;
+}
+} // namespace
+
+TEST(test_frame_logger, block) {
+    auto interface = make_interface();
+    sc::ContactMap contacts;
+    for (int id : {2, 1}) {
+        contacts[id].set_id(sc::ID(id, 0, 3));
+        contacts[id].set_type(sc::Contact::Type::QUADROTOR);
+    }
+
+    sc::FrameLogger logger;
+    logger.start(interface, 2, sc::FrameLogger::Policy::BLOCK);
+    EXPECT_TRUE(logger.running());
+    for (int i = 0; i < 20; i++) {
+        contacts[1].state()->pos() << i, 0, 0;
+        logger.log_frame(i, contacts);
+    }
+    logger.stop();
+    EXPECT_FALSE(logger.running());
+    EXPECT_EQ(logger.stats().frames, 20u);
+    EXPECT_EQ(logger.stats().dropped, 0u);
+
+    // every frame is sent in order, with the contacts as they were queued
+    auto &frames = interface->frames();
+    ASSERT_EQ(frames.size(), 20u);
+    int i = 0;
+    for (auto &frame : frames) {
+        EXPECT_EQ(frame->time(), i);
+        ASSERT_EQ(frame->contact_size(), 2);
+        EXPECT_EQ(frame->contact(0).id().id(), 2);
+        EXPECT_EQ(frame->contact(1).id().id(), 1);
+        EXPECT_EQ(frame->contact(1).id().team_id(), 3);
+        EXPECT_EQ(frame->contact(1).type(), scrimmage_proto::QUADROTOR);
+        EXPECT_EQ(frame->contact(1).state().position().x(), i);
+        i++;
+    }
+}
+
+TEST(test_frame_logger, drop) {
+    auto interface = make_interface();
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+
+    sc::FrameLogger logger;
+    logger.start(interface, 1, sc::FrameLogger::Policy::DROP);
+    for (int i = 0; i < 100; i++) {
+        logger.log_frame(i, contacts);
+    }
+    logger.stop();
+
+    // a frame is either queued or dropped
+    const sc::FrameLogger::Stats &stats = logger.stats();
+    EXPECT_EQ(stats.frames + stats.dropped, 100u);
+    EXPECT_GE(stats.frames, 1u);
+    EXPECT_EQ(interface->frames().size(), stats.frames);
+
+    sc::FrameLogger::Policy policy;
+    EXPECT_TRUE(sc::FrameLogger::parse_policy("decimate", policy));
+    EXPECT_EQ(policy, sc::FrameLogger::Policy::DECIMATE);
+    EXPECT_FALSE(sc::FrameLogger::parse_policy("sometimes", policy));
+}
+
+TEST(test_frame_logger, prebuilt_frames) {
+    auto interface = make_interface();
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+
+    // frames that were already built, and snapshots taken earlier, are sent
+    // in order with the others
+    sc::FrameLogger logger;
+    logger.start(interface, 2, sc::FrameLogger::Policy::BLOCK);
+    sc::FrameSnapshot snapshot;
+    for (int i = 0; i < 10; i++) {
+        if (i % 3 == 0) {
+            auto frame = std::make_shared<scrimmage_proto::Frame>();
+            frame->set_time(i);
+            logger.log_frame(frame);
+        } else if (i % 3 == 1) {
+            logger.log_frame(i, contacts);
+        } else {
+            snapshot.capture(i, contacts);
+            logger.log_frame(snapshot);
+        }
+    }
+    logger.stop();
+    EXPECT_EQ(logger.stats().frames, 10u);
+
+    auto &frames = interface->frames();
+    ASSERT_EQ(frames.size(), 10u);
+    int i = 0;
+    for (auto &frame : frames) {
+        EXPECT_EQ(frame->time(), i);
+        EXPECT_EQ(frame->contact_size(), i % 3 == 0 ? 0 : 1);
+        i++;
+    }
+}
+
+TEST(test_frame_logger, save_and_display) {
+    auto interface = make_interface();
+    sc::ContactMap contacts;
+    contacts[1].set_id(sc::ID(1, 0, 1));
+
+    // frames that are only saved never reach the GUI, the others reach it
+    // once and in order
+    sc::FrameLogger logger;
+    logger.start(interface, 2, sc::FrameLogger::Policy::BLOCK);
+    sc::FrameSnapshot snapshot;
+    for (int i = 0; i < 10; i++) {
+        if (i % 3 == 0) {
+            snapshot.capture(i, contacts);
+            snapshot.display = false;
+            logger.log_frame(snapshot);
+        } else {
+            logger.log_frame(i, contacts, i % 3 == 1, true);
+        }
+    }
+    logger.stop();
+    EXPECT_EQ(logger.stats().frames, 10u);
+
+    auto &frames = interface->frames();
+    ASSERT_EQ(frames.size(), 6u);
+    int i = 1;
+    for (auto &frame : frames) {
+        EXPECT_EQ(frame->time(), i);
+        i += i % 3 == 1 ? 1 : 2;
+    }
+}
@@ -0,0 +1,152 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/log/DeltaFrameLog.h>
+#include <scrimmage/log/FrameReader.h>
+#include <scrimmage/proto/Frame.pb.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sc = scrimmage;
+namespace sp = scrimmage_proto;
+
+namespace {
+// writes frames the way Log::save_frame does, prefixed by a varint size
+std::string write_frames(const std::string &filename, int num_frames) {
+    std::string bytes;
+    for (int i = 0; i < num_frames; i++) {
+        sp::Frame frame;
+        frame.set_time(i);
+        for (int j = 0; j <= i; j++) {
+            frame.add_contact()->mutable_id()->set_id(j);
+        }
+        std::string msg = frame.SerializeAsString();
+        for (size_t size = msg.size(); ; size >>= 7) {
+            bytes += static_cast<char>((size & 0x7F) | (size >= 0x80 ? 0x80 : 0));
+            if (size < 0x80) break;
+        }
+        bytes += msg;
+    }
+    std::ofstream(filename, std::ios::binary) << bytes;
+    return bytes;
+}
+} // namespace
+
+TEST(test_frame_reader, read) {
+    std::string filename = testing::TempDir() + "test_frame_reader.bin";
+    std::string bytes = write_frames(filename, 20);
+
+    sc::FrameReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ(reader.size(), bytes.size());
+
+    int i = 0;
+    for (const sp::Frame &frame : reader) {
+        EXPECT_EQ(frame.time(), i);
+        EXPECT_EQ(frame.contact_size(), i + 1);
+        i++;
+    }
+    EXPECT_EQ(i, 20);
+    EXPECT_TRUE(reader.clean_eof());
+
+    // skip to the third frame, remember where the fourth is and come back
+    reader.rewind();
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.frame().time(), 2);
+    size_t offset = reader.offset();
+    ASSERT_TRUE(reader.next());
+    reader.seek(offset);
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.frame().time(), 3);
+
+    std::remove(filename.c_str());
+}
+
+TEST(test_frame_reader, truncated) {
+    std::string filename = testing::TempDir() + "test_frame_reader_truncated.bin";
+    std::string bytes = write_frames(filename, 3);
+    std::ofstream(filename, std::ios::binary) << bytes.substr(0, bytes.size() - 2);
+
+    sc::FrameReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_TRUE(reader.next());
+    EXPECT_TRUE(reader.next());
+    EXPECT_FALSE(reader.next());
+    EXPECT_FALSE(reader.clean_eof());
+
+    EXPECT_FALSE(reader.open(filename + ".missing"));
+    std::remove(filename.c_str());
+}
+
+TEST(test_frame_reader, delta) {
+    std::string filename = testing::TempDir() + "test_frame_reader.delta";
+    sc::DeltaFrameWriter writer;
+    ASSERT_TRUE(writer.open(filename, 4));
+    for (int i = 0; i < 10; i++) {
+        sp::Frame frame;
+        frame.set_time(i);
+        frame.add_contact()->mutable_id()->set_id(i);
+        ASSERT_TRUE(writer.write_frame(frame));
+    }
+    ASSERT_TRUE(writer.close());
+
+    // a frames.delta file is detected and decoded
+    sc::FrameReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    int i = 0;
+    for (const sp::Frame &frame : reader) {
+        EXPECT_EQ(frame.time(), i);
+        EXPECT_EQ(frame.contact(0).id().id(), i);
+        i++;
+    }
+    EXPECT_EQ(i, 10);
+    EXPECT_TRUE(reader.clean_eof());
+
+    // its offsets count frames
+    reader.rewind();
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.next());
+    size_t offset = reader.offset();
+    EXPECT_EQ(offset, 2u);
+    ASSERT_TRUE(reader.next());
+    reader.seek(offset);
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.frame().time(), 2);
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,220 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/plugins/network/LinkNetwork/LinkNetwork.h>
+#include <scrimmage/common/Time.h>
+#include <scrimmage/entity/Entity.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/msgs/Simple.pb.h>
+#include <scrimmage/plugin_manager/Plugin.h>
+#include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessageQueue.h>
+#include <scrimmage/pubsub/NetworkDevice.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sc = scrimmage;
+
+namespace {
+class LinkNetworkTest : public ::testing::Test {
+ protected:
+    void init(std::map<std::string, std::string> params) {
+        network_.set_time(time_);
+        std::map<std::string, std::string> mission_params;
+        network_.init(mission_params, params);
+    }
+
+    // a device on a plugin of an entity at x on the x axis
+    sc::NetworkDevicePtr device(int id, double x) {
+        if (ents_.count(id) == 0) {
+            auto ent = std::make_shared<sc::Entity>();
+            ent->id().set_id(id);
+            ent->state() = std::make_shared<sc::State>();
+            ent->state()->pos() << x, 0, 0;
+            ents_[id] = ent;
+        }
+        auto plugin = std::make_shared<sc::Plugin>();
+        plugin->set_parent(ents_[id]);
+        return std::make_shared<sc::NetworkDevice>("topic", max_queue_size_, false, plugin);
+    }
+
+    void publish(const sc::NetworkDevicePtr &pub, int data) {
+        pubs_["topic"].push_back(pub);
+        pub->add_msg(std::make_shared<sc::Message<int>>(data));
+    }
+
+    void subscribe(const sc::NetworkDevicePtr &sub) {
+        subs_["topic"].push_back(sub);
+    }
+
+    // Step until t_end, returning each message received by sub with the
+    // time it arrived
+    std::vector<std::pair<int, double>> run(const sc::NetworkDevicePtr &sub,
+                                            double t_end) {
+        std::vector<std::pair<int, double>> received;
+        sc::MessageQueue msgs;
+        for (int i = 0; i * dt_ <= t_end + 1e-9; i++) {
+            time_->set_t(i * dt_);
+            network_.step(pubs_, subs_);
+            sub->pop_msgs(msgs);
+            for (size_t j = 0; j < msgs.size(); j++) {
+                auto msg = std::static_pointer_cast<sc::Message<int>>(msgs[j]);
+                received.emplace_back(msg->data, time_->t());
+            }
+        }
+        return received;
+    }
+
+    const double dt_ = 0.1;
+    unsigned int max_queue_size_ = 0;
+    std::shared_ptr<sc::Time> time_ = std::make_shared<sc::Time>();
+    sc::network::LinkNetwork network_;
+    std::map<int, sc::EntityPtr> ents_;
+    std::map<std::string, std::list<sc::NetworkDevicePtr>> pubs_, subs_;
+};
+} // namespace
+
+TEST_F(LinkNetworkTest, latency_ordering) {
+    init({{"latency", "0.5"}, {"propagation_speed", "100"}});
+    auto far = device(1, 100);
+    auto near = device(2, 10);
+    auto sub = device(3, 0);
+    subscribe(sub);
+
+    // published on the same step, the nearer publisher's message arrives
+    // first, after the latency plus its propagation delay
+    publish(far, 1);
+    publish(near, 2);
+    auto received = run(sub, 2);
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0].first, 2);
+    EXPECT_NEAR(received[0].second, 0.6, 1e-9);
+    EXPECT_EQ(received[1].first, 1);
+    EXPECT_NEAR(received[1].second, 1.5, 1e-9);
+    EXPECT_EQ(network_.num_in_flight(), 0u);
+}
+
+TEST_F(LinkNetworkTest, counts_on_arrival) {
+    init({{"latency", "0.5"}, {"monitor_publisher_topics", "topic"},
+          {"monitor_subscriber_topics", "topic, *"}});
+    auto pub = device(1, 0);
+    subscribe(device(2, 10));
+    subscribe(device(3, 20));
+    publish(pub, 1);
+
+    // the message is counted as published when it is sent and as received
+    // by each subscriber on the step it arrives
+    sc::MessageQueue msgs;
+    for (int i = 0; i <= 10; i++) {
+        time_->set_t(i * dt_);
+        network_.step(pubs_, subs_);
+        const unsigned int received = i == 5 ? 2 : 0;
+        EXPECT_EQ(network_.pub_counts().at("topic"), i == 0 ? 1u : 0u);
+        EXPECT_EQ(network_.sub_counts().at("topic"), received);
+        EXPECT_EQ(network_.sub_counts().at("*"), received);
+    }
+
+    // messages still in flight aren't counted
+    publish(pub, 2);
+    time_->set_t(11 * dt_);
+    network_.step(pubs_, subs_);
+    EXPECT_EQ(network_.sub_counts().at("topic"), 0u);
+    EXPECT_EQ(network_.num_in_flight(), 2u);
+}
+
+TEST_F(LinkNetworkTest, link_queueing) {
+    // each message takes 1 second to send and waits for the ones before it
+    init({{"bandwidth", "8"}, {"msg_bytes", "1"}});
+    auto pub = device(1, 0);
+    auto sub = device(2, 10);
+    subscribe(sub);
+    for (int i = 0; i < 3; i++) publish(pub, i);
+
+    auto received = run(sub, 4);
+    ASSERT_EQ(received.size(), 3u);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(received[i].first, i);
+        EXPECT_NEAR(received[i].second, i + 1, 1e-9);
+    }
+}
+
+TEST_F(LinkNetworkTest, max_backlog) {
+    // the third message would wait 2 seconds for the link
+    init({{"bandwidth", "8"}, {"msg_bytes", "1"}, {"max_backlog", "1.5"}});
+    auto pub = device(1, 0);
+    auto sub = device(2, 10);
+    subscribe(sub);
+    for (int i = 0; i < 3; i++) publish(pub, i);
+
+    auto received = run(sub, 4);
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0].first, 0);
+    EXPECT_EQ(received[1].first, 1);
+}
+
+TEST_F(LinkNetworkTest, same_entity) {
+    init({{"latency", "1"}, {"bandwidth", "8"}, {"msg_bytes", "1"}});
+    auto pub = device(1, 0);
+    auto local = device(1, 0);
+    auto remote = device(2, 10);
+    subscribe(local);
+    subscribe(remote);
+    publish(pub, 7);
+
+    // the plugin on the same entity gets the message without a link delay
+    time_->set_t(0);
+    network_.step(pubs_, subs_);
+    EXPECT_EQ(local->msg_list_size(), 1u);
+    EXPECT_EQ(remote->msg_list_size(), 0u);
+    EXPECT_EQ(network_.num_in_flight(), 1u);
+}
+
+TEST(test_link_network, message_size) {
+    // protobuf messages are sized by their encoding, other C++ messages
+    // have no size estimate
+    simple::Vector3d v;
+    v.set_x(1);
+    v.set_y(2);
+    auto pb_msg = std::make_shared<sc::Message<simple::Vector3d>>(v);
+    EXPECT_EQ(pb_msg->size_bytes(), v.ByteSizeLong());
+    EXPECT_GT(pb_msg->size_bytes(), 0u);
+
+    auto int_msg = std::make_shared<sc::Message<int>>(1);
+    EXPECT_EQ(int_msg->size_bytes(), 0u);
+    int_msg->serialized_data = "abc";
+    EXPECT_EQ(int_msg->size_bytes(), 3u);
+}
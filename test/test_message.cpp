@@ -0,0 +1,373 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <scrimmage/common/Time.h>
+#include <scrimmage/msgs/Simple.pb.h>
+#include <scrimmage/plugin_manager/Plugin.h>
+#include <scrimmage/pubsub/AtomicMessageQueue.h>
+#include <scrimmage/pubsub/Message.h>
+#include <scrimmage/pubsub/MessageBase.h>
+#include <scrimmage/pubsub/MessagePool.h>
+#include <scrimmage/pubsub/MessageQueue.h>
+#include <scrimmage/pubsub/NetworkDevice.h>
+#include <scrimmage/pubsub/Publisher.h>
+#include <scrimmage/pubsub/Subscriber.h>
+#include <scrimmage/simcontrol/SimUtils.h>
+
+#include <atomic>
+#include <functional>
+
+#include <memory>
+#include <string>
+#include <thread> // NOLINT
+#include <typeinfo>
+#include <vector>
+
+namespace sc = scrimmage;
+
+namespace {
+class Untagged : public sc::MessageBase {
+ public:
+    int value = 3;
+};
+} // namespace
+
+TEST(test_message, type_tag) {
+    auto msg = std::make_shared<sc::Message<int>>(1);
+    EXPECT_EQ(msg->type, &typeid(sc::Message<int>));
+
+    sc::MessageBasePtr base = msg;
+    const std::type_info *known = &typeid(sc::Message<int>);
+    auto cast = sc::msg_cast<sc::Message<int>>(base, known);
+    ASSERT_NE(cast, nullptr);
+    EXPECT_EQ(cast->data, 1);
+}
+
+TEST(test_message, wrong_type) {
+    sc::MessageBasePtr msg = std::make_shared<sc::Message<int>>(1);
+    const std::type_info *known = &typeid(sc::Message<std::string>);
+    EXPECT_EQ(sc::msg_cast<sc::Message<std::string>>(msg, known), nullptr);
+    EXPECT_EQ(known, &typeid(sc::Message<std::string>));
+}
+
+TEST(test_message, learns_equal_type) {
+    sc::MessageBasePtr msg = std::make_shared<sc::Message<int>>(1);
+    const std::type_info *known = nullptr;
+    ASSERT_NE(sc::msg_cast<sc::Message<int>>(msg, known), nullptr);
+#if !defined(CHECKED_MSG_CASTS) || !CHECKED_MSG_CASTS
+    EXPECT_EQ(known, msg->type);
+#endif
+}
+
+TEST(test_message, untagged) {
+    sc::MessageBasePtr msg = std::make_shared<Untagged>();
+    const std::type_info *known = &typeid(Untagged);
+    auto cast = sc::msg_cast<Untagged>(msg, known);
+    ASSERT_NE(cast, nullptr);
+    EXPECT_EQ(cast->value, 3);
+    EXPECT_EQ(sc::msg_cast<sc::Message<int>>(msg, known), nullptr);
+}
+
+TEST(test_message, atomic_queue_order) {
+    sc::AtomicMessageQueue queue;
+    for (int i = 0; i < 5; i++) {
+        queue.push(std::make_shared<sc::Message<int>>(i));
+    }
+    EXPECT_EQ(queue.size(), 5u);
+
+    sc::MessageQueue msgs;
+    queue.drain(msgs);
+    EXPECT_TRUE(queue.empty());
+    ASSERT_EQ(msgs.size(), 5u);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[i])->data, i);
+    }
+}
+
+TEST(test_message, atomic_queue_bounded) {
+    sc::AtomicMessageQueue queue;
+    for (int i = 0; i < 5; i++) {
+        queue.push(std::make_shared<sc::Message<int>>(i));
+    }
+
+    // only the newest messages are kept
+    sc::MessageQueue msgs;
+    queue.drain(msgs, 2);
+    ASSERT_EQ(msgs.size(), 2u);
+    EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[0])->data, 3);
+    EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[1])->data, 4);
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(test_message, atomic_queue_blocks) {
+    // an unbounded queue spans several blocks, which are reused once drained
+    sc::AtomicMessageQueue queue;
+    sc::MessageQueue msgs;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 100; i++) {
+            queue.push(std::make_shared<sc::Message<int>>(i));
+        }
+        EXPECT_EQ(queue.size(), 100u);
+        EXPECT_EQ(sc::AtomicMessageQueue(queue).size(), 100u);
+
+        msgs.clear();
+        EXPECT_EQ(queue.drain(msgs), 0u);
+        ASSERT_EQ(msgs.size(), 100u);
+        for (int i = 0; i < 100; i++) {
+            EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[i])->data, i);
+        }
+        EXPECT_TRUE(queue.empty());
+    }
+
+    // bounding the queue keeps the newest messages
+    for (int i = 0; i < 100; i++) {
+        queue.push(std::make_shared<sc::Message<int>>(i));
+    }
+    queue.set_capacity(1);
+    msgs.clear();
+    queue.drain(msgs);
+    ASSERT_EQ(msgs.size(), 1u);
+    EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[0])->data, 99);
+}
+
+TEST(test_message, atomic_queue_producers) {
+    sc::AtomicMessageQueue queue;
+    const int num_threads = 4;
+    const int num_msgs = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < num_msgs; i++) {
+                queue.push(std::make_shared<sc::Message<int>>(t * num_msgs + i));
+            }
+        });
+    }
+
+    // drain while the producers are running
+    sc::MessageQueue msgs;
+    while (msgs.size() < static_cast<size_t>(num_threads * num_msgs)) {
+        queue.drain(msgs);
+    }
+    for (auto &thread : threads) thread.join();
+
+    // each producer's messages arrive in the order they were pushed
+    std::vector<int> last(num_threads, -1);
+    for (size_t i = 0; i < msgs.size(); i++) {
+        int data = std::static_pointer_cast<sc::Message<int>>(msgs[i])->data;
+        int t = data / num_msgs;
+        EXPECT_GT(data % num_msgs, last[t]);
+        last[t] = data % num_msgs;
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(test_message, atomic_queue_ring) {
+    const size_t capacity = 3;
+    sc::AtomicMessageQueue queue(capacity);
+
+    // the ring never holds more than its capacity between pops
+    for (int i = 0; i < 10; i++) {
+        queue.push(std::make_shared<sc::Message<int>>(i));
+        EXPECT_LE(queue.size(), capacity);
+    }
+
+    sc::MessageQueue msgs;
+    EXPECT_EQ(queue.drain(msgs), 7u);
+    ASSERT_EQ(msgs.size(), capacity);
+    for (size_t i = 0; i < capacity; i++) {
+        int data = std::static_pointer_cast<sc::Message<int>>(msgs[i])->data;
+        EXPECT_EQ(data, 7 + static_cast<int>(i));
+    }
+    EXPECT_TRUE(queue.empty());
+
+    // concurrent producers
+    const int num_threads = 4;
+    const int num_msgs = 10000;
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < num_msgs; i++) {
+                queue.push(std::make_shared<sc::Message<int>>(t * num_msgs + i));
+            }
+            done++;
+        });
+    }
+
+    size_t received = 0, dropped = 0;
+    std::vector<int> last(num_threads, -1);
+    while (done < num_threads || !queue.empty()) {
+        EXPECT_LE(queue.size(), capacity);
+        msgs.clear();
+        dropped += queue.drain(msgs);
+        EXPECT_LE(msgs.size(), capacity);
+        received += msgs.size();
+
+        // each producer's messages still arrive in the order they were pushed
+        for (size_t i = 0; i < msgs.size(); i++) {
+            int data = std::static_pointer_cast<sc::Message<int>>(msgs[i])->data;
+            int t = data / num_msgs;
+            EXPECT_GT(data % num_msgs, last[t]);
+            last[t] = data % num_msgs;
+        }
+    }
+    for (auto &thread : threads) thread.join();
+    EXPECT_EQ(received + dropped, static_cast<size_t>(num_threads * num_msgs));
+}
+
+TEST(test_message, device_bounded) {
+    unsigned int max_queue_size = 2;
+    sc::NetworkDevice device("topic", max_queue_size, true, std::make_shared<sc::Plugin>());
+    for (int i = 0; i < 5; i++) {
+        device.add_msg(std::make_shared<sc::Message<int>>(i));
+        EXPECT_LE(device.msg_list_size(), max_queue_size);
+    }
+
+    sc::MessageQueue msgs;
+    device.pop_msgs(msgs);
+    ASSERT_EQ(msgs.size(), 2u);
+    EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[0])->data, 3);
+    EXPECT_EQ(std::static_pointer_cast<sc::Message<int>>(msgs[1])->data, 4);
+}
+
+TEST(test_message, pending_callbacks) {
+    auto plugin = std::make_shared<sc::Plugin>();
+
+    int received = 0;
+    auto callback = [&](sc::MessagePtr<int> msg) {received += msg->data;};
+    unsigned int max_queue_size = 0;
+    auto sub = std::make_shared<sc::Subscriber<int, decltype(callback)>>(
+        "topic", max_queue_size, false, plugin, callback);
+    plugin->subs().push_back(sub);
+    EXPECT_FALSE(plugin->has_pending_msgs());
+
+    sub->add_msg(std::make_shared<sc::Message<int>>(2));
+    sub->add_msg(std::make_shared<sc::Message<int>>(3));
+    EXPECT_TRUE(plugin->has_pending_msgs());
+
+    sc::run_callbacks(plugin);
+    EXPECT_EQ(received, 5);
+    EXPECT_FALSE(plugin->has_pending_msgs());
+    EXPECT_FALSE(sub->has_msgs());
+
+    // nothing is pending, so nothing is delivered again
+    sc::run_callbacks(plugin);
+    EXPECT_EQ(received, 5);
+}
+
+TEST(test_message, pool_recycles) {
+    sc::Publisher pub;
+    void *first = nullptr;
+    {
+        auto msg = pub.make_msg<int>(4);
+        EXPECT_EQ(msg->data, 4);
+        EXPECT_EQ(msg->type, &typeid(sc::Message<int>));
+        first = msg.get();
+    }
+
+    // the freed block is reused for the next message of the same size,
+    // whether it is made by a publisher or not
+    auto msg = sc::make_msg<int>(5);
+    EXPECT_EQ(msg.get(), first);
+    EXPECT_EQ(msg->data, 5);
+
+    // messages can be freed by other threads, even ones that have exited
+    std::thread([&]() {msg = nullptr;}).join();
+    auto str = pub.make_msg<std::string>("pooled");
+    EXPECT_EQ(str->data, "pooled");
+}
+
+TEST(test_message, device_stats) {
+    auto plugin = std::make_shared<sc::Plugin>();
+    auto time = std::make_shared<sc::Time>();
+    time->set_t(1.5);
+    plugin->set_time(time);
+
+    int received = 0;
+    auto callback = [&](sc::MessagePtr<int> msg) {received += msg->data;};
+    unsigned int max_queue_size = 2;
+    auto sub = std::make_shared<sc::Subscriber<int, decltype(callback)>>(
+        "topic", max_queue_size, true, plugin, callback);
+    plugin->subs().push_back(sub);
+    sub->collect_stats(true);
+
+    // messages are sized once, when they are published
+    sc::Publisher pub("topic", max_queue_size, false, plugin);
+    pub.collect_stats(true);
+    for (int i = 1; i <= 3; i++) {
+        auto msg = std::make_shared<sc::Message<int>>(i);
+        msg->serialized_data = "xyz";
+        msg->time = 1.0;
+        pub.publish(msg, false);
+        EXPECT_EQ(msg->published_size, 3u);
+        sub->add_msg(msg);
+    }
+    sc::run_callbacks(plugin);
+    EXPECT_EQ(received, 5);
+
+    // the oldest message was dropped by the max queue size
+    const sc::NetworkDeviceStats &stats = sub->stats();
+    EXPECT_EQ(stats.msgs, 2u);
+    EXPECT_EQ(stats.bytes, 6u);
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.max_queue_depth, 3u);
+    EXPECT_EQ(stats.callback_time_ns.count(), 1u);
+    EXPECT_DOUBLE_EQ(stats.latency_sum, 1.0);
+    EXPECT_EQ(stats.latency_us.count(), 2u);
+    EXPECT_EQ(stats.latency_us.quantile(0.5), 1u << 19); // 0.5 s < 2^19 us
+
+    // protobuf messages are counted by their encoded size
+    unsigned int unbounded = 0;
+    sc::Publisher device("pb", unbounded, false, plugin);
+    simple::Vector3d v;
+    v.set_x(1);
+    device.publish(std::make_shared<sc::Message<simple::Vector3d>>(v), false);
+    sc::MessageQueue msgs;
+    device.pop_msgs(msgs);
+    EXPECT_EQ(device.stats().bytes, 0u); // not collecting stats
+
+    device.collect_stats(true);
+    device.publish(std::make_shared<sc::Message<simple::Vector3d>>(v), false);
+    device.pop_msgs(msgs);
+    EXPECT_EQ(device.stats().bytes, v.ByteSizeLong());
+
+    sc::Log2Histogram hist;
+    hist.add(0);
+    hist.add(1);
+    hist.add(5);
+    EXPECT_EQ(hist.count(), 3u);
+    EXPECT_EQ(hist.quantile(0.3), 0u);
+    EXPECT_EQ(hist.quantile(1.0), 8u);
+}
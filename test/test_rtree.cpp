@@ -32,7 +32,9 @@
 
 #include <iostream>
 
+#include <algorithm>
 #include <list>
+#include <vector>
 #include <limits.h>
 
 #include <scrimmage/common/RTree.h>
@@ -202,3 +204,184 @@ TEST(rtree_test, nearest_n_neighbors_minus_self)
     rtree.nearest_n_neighbors(c.state()->pos_const(), rtree_neighbors, num_neighbors);
     ASSERT_EQ(rtree_neighbors.size(), num_neighbors);
 }
+
+TEST(rtree_test, incremental_update)
+{
+    const int num_contacts = 1000;
+    const double range = 1000;
+    const double circ_range = 100;
+
+    sc::Random rand;
+    rand.seed(1);
+    auto rnd = [&]() {return rand.rng_uniform() * range;};
+
+    std::vector<Eigen::Vector3d> pos(num_contacts);
+    std::vector<sc::ID> ids(num_contacts);
+    for (int i = 0; i < num_contacts; i++) {
+        pos[i] = Eigen::Vector3d(rnd(), rnd(), rnd());
+        ids[i] = sc::ID(i, 0, i % 2);
+    }
+
+    sc::RTree rtree;
+    rtree.init(num_contacts);
+
+    auto check = [&](const Eigen::Vector3d &own, int team_id) {
+        std::vector<sc::ID> neighbors;
+        rtree.neighbors_in_range(own, neighbors, circ_range, -1, team_id);
+        std::sort(neighbors.begin(), neighbors.end(), is_less_than_id);
+
+        std::vector<sc::ID> expected;
+        for (int i = 0; i < num_contacts; i++) {
+            if (ids[i].id() >= 0 && (pos[i] - own).norm() < circ_range &&
+                    (team_id == -1 || ids[i].team_id() == team_id)) {
+                expected.push_back(ids[i]);
+            }
+        }
+        ASSERT_EQ(neighbors.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(neighbors[i].id(), expected[i].id());
+        }
+    };
+
+    auto update_all = [&]() {
+        for (int i = 0; i < num_contacts; i++) {
+            if (ids[i].id() >= 0) rtree.update(pos[i], ids[i]);
+        }
+        rtree.commit();
+    };
+
+    // the first commit adds everything, which is a bulk load
+    update_all();
+    EXPECT_EQ(rtree.update_stats().rebuilds, 1u);
+    check(pos[0], -1);
+    check(pos[0], 1);
+
+    // moving a few entities updates them in place
+    for (int i = 0; i < 10; i++) {
+        pos[i] = pos[i + 10];
+    }
+    rtree.remove(ids[20]);
+    ids[20].set_id(-1);
+    update_all();
+    EXPECT_EQ(rtree.update_stats().rebuilds, 1u);
+    EXPECT_EQ(rtree.update_stats().updates, 1u);
+    EXPECT_EQ(rtree.update_stats().moved, 11u);
+    check(pos[10], -1);
+    check(pos[10], 0);
+
+    // moving most of them bulk loads the trees again
+    for (int i = 0; i < num_contacts; i++) {
+        pos[i] += Eigen::Vector3d(1, 0, 0);
+    }
+    update_all();
+    EXPECT_EQ(rtree.update_stats().rebuilds, 2u);
+    check(pos[10], -1);
+    check(pos[11], 1);
+
+    // nothing moved
+    update_all();
+    EXPECT_EQ(rtree.update_stats().rebuilds, 2u);
+    EXPECT_EQ(rtree.update_stats().updates, 1u);
+}
+
+TEST(rtree_test, squared_distances)
+{
+    int num_contacts = 1000;
+    double range = 1000;
+    double circ_range = 200;
+
+    sc::Contact own;
+    sc::RTree rtree;
+    std::list<sc::Contact> contacts;
+    populate_tree_randomly(num_contacts, range, false, contacts, rtree, own);
+    const Eigen::Vector3d &pos = own.state()->pos_const();
+
+    std::vector<sc::ID> ids;
+    std::vector<sc::Neighbor> neighbors;
+    rtree.neighbors_in_range(pos, ids, circ_range, 3);
+    rtree.neighbors_in_range(pos, neighbors, circ_range, 3);
+    ASSERT_EQ(ids.size(), neighbors.size());
+
+    // the callback sees the same entities
+    size_t num_visited = 0;
+    rtree.for_each_in_range(pos, circ_range, [&](const sc::ID &id, double /*dist_sq*/) {
+        num_visited++;
+        EXPECT_NE(std::find(ids.begin(), ids.end(), id), ids.end());
+    }, 3);
+    EXPECT_EQ(num_visited, ids.size());
+
+    for (sc::Contact &c : contacts) {
+        auto it = std::find_if(neighbors.begin(), neighbors.end(),
+            [&](const sc::Neighbor &n) {return n.id == c.id();});
+        if (it != neighbors.end()) {
+            EXPECT_NEAR(it->dist_sq, (c.state()->pos() - pos).squaredNorm(), 1e-6);
+        }
+    }
+
+    rtree.nearest_n_neighbors(pos, ids, 10);
+    rtree.nearest_n_neighbors(pos, neighbors, 10);
+    ASSERT_EQ(neighbors.size(), 10u);
+    for (const sc::Neighbor &n : neighbors) {
+        EXPECT_NE(std::find(ids.begin(), ids.end(), n.id), ids.end());
+    }
+}
+
+TEST(rtree_test, neighbor_lists)
+{
+    int num_contacts = 1000;
+    double range = 1000;
+
+    sc::Contact own;
+    sc::RTree rtree;
+    std::list<sc::Contact> contacts;
+    populate_tree_randomly(num_contacts, range, false, contacts, rtree, own);
+
+    std::vector<double> radii {50, 120, 50};
+    std::vector<int> radius_ids;
+    for (double r : radii) radius_ids.push_back(rtree.register_neighbor_radius(r));
+    EXPECT_EQ(radius_ids[0], radius_ids[2]);
+    EXPECT_EQ(rtree.num_neighbor_radii(), 2u);
+
+    sc::NeighborList list;
+    EXPECT_FALSE(rtree.neighbor_list(radius_ids[0], 0, list));
+
+    // split the rows between two "threads"
+    size_t n = rtree.begin_neighbor_lists(2);
+    ASSERT_EQ(n, contacts.size());
+    rtree.compute_neighbor_lists(n / 3, n, 1);
+    rtree.compute_neighbor_lists(0, n / 3, 0);
+    rtree.finish_neighbor_lists();
+
+    std::vector<sc::ID> expected;
+    for (size_t i = 0; i < radii.size(); i++) {
+        for (sc::Contact &c : contacts) {
+            ASSERT_TRUE(rtree.neighbor_list(radius_ids[i], c.id().id(), list));
+            rtree.neighbors_in_range(c.state()->pos(), expected, radii[i], c.id().id());
+            ASSERT_EQ(list.size(), expected.size());
+
+            std::vector<sc::ID> ids;
+            for (const sc::Neighbor &nb : list) {
+                ids.push_back(nb.id);
+                EXPECT_LT(nb.dist_sq, radii[i] * radii[i]);
+            }
+            std::sort(ids.begin(), ids.end(), is_less_than_id);
+            std::sort(expected.begin(), expected.end(), is_less_than_id);
+            for (size_t j = 0; j < ids.size(); j++) {
+                EXPECT_EQ(ids[j].id(), expected[j].id());
+            }
+        }
+    }
+
+    // the lists are invalidated once the entities move, even though the
+    // tree itself isn't updated until the next step
+    const int id = contacts.front().id().id();
+    EXPECT_TRUE(rtree.neighbor_list(radius_ids[0], id, list));
+    rtree.invalidate_neighbor_lists();
+    EXPECT_FALSE(rtree.neighbor_list(radius_ids[0], id, list));
+
+    // changing the tree invalidates the lists
+    rtree.compute_neighbor_lists();
+    EXPECT_TRUE(rtree.neighbor_list(radius_ids[0], id, list));
+    rtree.clear();
+    EXPECT_FALSE(rtree.neighbor_list(radius_ids[0], contacts.front().id().id(), list));
+}
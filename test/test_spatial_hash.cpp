@@ -0,0 +1,175 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <scrimmage/common/ID.h>
+#include <scrimmage/common/Random.h>
+#include <scrimmage/common/RTree.h>
+#include <scrimmage/common/SpatialHash.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace sc = scrimmage;
+
+namespace {
+
+std::vector<std::pair<Eigen::Vector3d, sc::ID>> random_points(
+        int num, double range, int num_teams) {
+    sc::Random rand;
+    rand.seed(1);
+    std::vector<std::pair<Eigen::Vector3d, sc::ID>> points;
+    for (int i = 0; i < num; i++) {
+        Eigen::Vector3d pos(rand.rng_uniform() * range,
+                            rand.rng_uniform() * range,
+                            rand.rng_uniform() * range);
+        points.emplace_back(pos, sc::ID(i + 1, 0, i % num_teams + 1));
+    }
+    return points;
+}
+
+std::vector<int> ids(const std::vector<sc::ID> &neighbors) {
+    std::vector<int> out;
+    for (const sc::ID &id : neighbors) out.push_back(id.id());
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace
+
+TEST(spatial_hash_test, range_matches_brute_force) {
+    auto points = random_points(2000, 1000, 3);
+
+    // a fixed cell size and an adaptive one
+    for (double cell_size : {50.0, 0.0}) {
+        sc::SpatialHash hash(cell_size);
+        hash.init(points.size());
+        for (auto &p : points) hash.add(p.first, p.second);
+
+        for (double dist : {1.0, 75.0, 300.0, 5000.0}) {
+            for (int team_id : {-1, 2}) {
+                const Eigen::Vector3d &pos = points[7].first;
+                const int self_id = points[7].second.id();
+
+                std::vector<int> expected;
+                for (auto &p : points) {
+                    if ((p.first - pos).norm() < dist && p.second.id() != self_id &&
+                        (team_id == -1 || p.second.team_id() == team_id)) {
+                        expected.push_back(p.second.id());
+                    }
+                }
+                std::sort(expected.begin(), expected.end());
+
+                std::vector<sc::ID> neighbors;
+                hash.neighbors_in_range(pos, neighbors, dist, self_id, team_id);
+                EXPECT_EQ(ids(neighbors), expected);
+            }
+        }
+    }
+}
+
+TEST(spatial_hash_test, nearest_matches_brute_force) {
+    auto points = random_points(2000, 1000, 3);
+
+    sc::SpatialHash hash(10);
+    for (auto &p : points) hash.add(p.first, p.second);
+
+    // query from an entity and from far outside the points
+    std::vector<Eigen::Vector3d> queries {points[3].first, Eigen::Vector3d(-5000, 0, 0)};
+    for (const Eigen::Vector3d &pos : queries) {
+        for (unsigned int n : {1u, 10u, 100u}) {
+            std::vector<std::pair<double, int>> dists;
+            for (auto &p : points) {
+                if (p.second.team_id() == 1) {
+                    dists.emplace_back((p.first - pos).norm(), p.second.id());
+                }
+            }
+            std::sort(dists.begin(), dists.end());
+            std::vector<int> expected;
+            for (unsigned int i = 0; i < n; i++) expected.push_back(dists[i].second);
+            std::sort(expected.begin(), expected.end());
+
+            std::vector<sc::ID> neighbors;
+            hash.nearest_n_neighbors(pos, neighbors, n, -1, 1);
+            EXPECT_EQ(ids(neighbors), expected);
+        }
+    }
+
+    // more neighbors than there are entities
+    std::vector<sc::ID> neighbors;
+    hash.nearest_n_neighbors(points[0].first, neighbors, 5000);
+    EXPECT_EQ(neighbors.size(), points.size());
+}
+
+TEST(spatial_hash_test, rtree_backend) {
+    auto points = random_points(500, 1000, 2);
+
+    sc::RTree rtree;
+    sc::RTree hashed;
+    hashed.set_index(std::make_shared<sc::SpatialHash>());
+    rtree.init(points.size());
+    hashed.init(points.size());
+
+    // fill with add() the first time and with update()/commit() after
+    for (int step = 0; step < 3; step++) {
+        for (auto &p : points) {
+            if (step == 0) {
+                rtree.add(p.first, p.second);
+                hashed.add(p.first, p.second);
+            } else {
+                rtree.update(p.first, p.second);
+                hashed.update(p.first, p.second);
+            }
+        }
+        rtree.commit();
+        hashed.commit();
+
+        for (size_t i = 0; i < points.size(); i += 50) {
+            const Eigen::Vector3d &pos = points[i].first;
+            const int self_id = points[i].second.id();
+
+            std::vector<sc::ID> expected, neighbors;
+            rtree.neighbors_in_range(pos, expected, 200, self_id);
+            hashed.neighbors_in_range(pos, neighbors, 200, self_id);
+            EXPECT_EQ(ids(neighbors), ids(expected));
+
+            rtree.nearest_n_neighbors(pos, expected, 5, self_id, 2);
+            hashed.nearest_n_neighbors(pos, neighbors, 5, self_id, 2);
+            EXPECT_EQ(ids(neighbors), ids(expected));
+        }
+
+        for (auto &p : points) p.first += Eigen::Vector3d(10, -5, 1) * step;
+    }
+}
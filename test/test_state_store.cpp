@@ -0,0 +1,115 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/common/ID.h>
+#include <scrimmage/math/State.h>
+#include <scrimmage/math/StateStore.h>
+#include <Eigen/Dense>
+
+#include <memory>
+#include <vector>
+
+namespace sc = scrimmage;
+using Eigen::Vector3d;
+
+TEST(test_state_store, view) {
+    auto store = std::make_shared<sc::StateStore>();
+
+    auto state = std::make_shared<sc::State>();
+    state->pos() = Vector3d(1, 2, 3);
+    state->vel() = Vector3d(4, 5, 6);
+
+    store->add(*state, sc::ID(7, 0, 1));
+    EXPECT_EQ(store->size(), 1);
+    EXPECT_EQ(store->id(0).id(), 7);
+    EXPECT_EQ(store->pos(0), Vector3d(1, 2, 3));
+    EXPECT_EQ(store->vel(0), Vector3d(4, 5, 6));
+
+    // writes through the state and the store are seen by both
+    state->pos()(0) = 10;
+    EXPECT_EQ(store->pos(0)(0), 10);
+    store->vel(0) = Vector3d(0, 0, 1);
+    EXPECT_EQ(state->vel_const(), Vector3d(0, 0, 1));
+
+    // a copy is independent of the store
+    sc::State copy = *state;
+    copy.pos()(1) = -1;
+    EXPECT_EQ(state->pos()(1), 2);
+
+    // assignment writes into the store
+    *state = copy;
+    EXPECT_EQ(store->pos(0)(1), -1);
+
+    // the values stay with the state after it is removed
+    store->remove(*state);
+    EXPECT_EQ(store->num_active(), 0);
+    EXPECT_EQ(state->pos(), Vector3d(10, -1, 3));
+    store->pos(0) = Vector3d(0, 0, 0);
+    EXPECT_EQ(state->pos(), Vector3d(10, -1, 3));
+}
+
+TEST(test_state_store, slots) {
+    auto store = std::make_shared<sc::StateStore>();
+
+    const int n = sc::StateStore::block_size + 10;
+    std::vector<std::shared_ptr<sc::State>> states;
+    for (int i = 0; i < n; i++) {
+        states.push_back(std::make_shared<sc::State>());
+        states.back()->pos() = Vector3d(i, 0, 0);
+        store->add(*states.back(), sc::ID(i + 1, 0, 1));
+    }
+
+    // slots don't move when new blocks are added
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(&states[i]->pos(), &store->pos(i));
+    }
+
+    // destroying a state frees its slot
+    states[3] = nullptr;
+    store->remove(*states[5]);
+
+    int count = 0;
+    double sum = 0;
+    store->for_each([&](int slot) {
+        count++;
+        sum += store->pos(slot)(0);
+    });
+    EXPECT_EQ(count, n - 2);
+    EXPECT_EQ(sum, n * (n - 1) / 2 - 3 - 5);
+
+    // freed slots are reused
+    auto state = std::make_shared<sc::State>();
+    store->add(*state, sc::ID(n + 1, 0, 1));
+    EXPECT_EQ(store->size(), n);
+    EXPECT_EQ(store->num_active(), n - 1);
+}
@@ -0,0 +1,88 @@
+/*!
+ * @file
+ *
+ * @section LICENSE
+ *
+ * Copyright (C) 2017 by the Georgia Tech Research Institute (GTRI)
+ *
+ * This file is part of SCRIMMAGE.
+ *
+ *   SCRIMMAGE is free software: you can redistribute it and/or modify it under
+ *   the terms of the GNU Lesser General Public License as published by the
+ *   Free Software Foundation, either version 3 of the License, or (at your
+ *   option) any later version.
+ *
+ *   SCRIMMAGE is distributed in the hope that it will be useful, but WITHOUT
+ *   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ *   License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with SCRIMMAGE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @author Kevin DeMarco <kevin.demarco@gtri.gatech.edu>
+ * @author Eric Squires <eric.squires@gtri.gatech.edu>
+ * @date 31 July 2017
+ * @version 0.1.0
+ * @brief Brief file description.
+ * @section DESCRIPTION
+ * A Long description goes here.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <scrimmage/common/TaskScheduler.h>
+
+#include <atomic>
+#include <vector>
+
+namespace sc = scrimmage;
+
+TEST(test_task_scheduler, visits_each_index_once) {
+    const size_t n = 1000;
+    for (int num_threads : {1, 2, 4}) {
+        sc::TaskScheduler scheduler;
+        scheduler.start(num_threads, 7);
+        EXPECT_EQ(scheduler.num_threads(), num_threads);
+
+        std::vector<std::atomic<int>> visits(n);
+        for (auto &v : visits) v = 0;
+
+        // repeat the phase to exercise waking the workers many times
+        const int num_phases = 200;
+        for (int i = 0; i < num_phases; i++) {
+            auto func = [&](size_t begin, size_t end, int thread_id) {
+                EXPECT_GE(thread_id, 0);
+                EXPECT_LT(thread_id, num_threads);
+                for (size_t j = begin; j < end; j++) visits[j]++;
+                return true;
+            };
+            EXPECT_TRUE(scheduler.run("phase", n, func));
+        }
+
+        for (auto &v : visits) {
+            EXPECT_EQ(v, num_phases);
+        }
+
+        auto it = scheduler.phase_stats().find("phase");
+        ASSERT_NE(it, scheduler.phase_stats().end());
+        EXPECT_EQ(it->second.count, static_cast<uint64_t>(num_phases));
+        EXPECT_GT(it->second.speedup(), 0.0);
+    }
+}
+
+TEST(test_task_scheduler, failure) {
+    sc::TaskScheduler scheduler;
+    scheduler.start(3);
+
+    auto func = [&](size_t begin, size_t end, int /*thread_id*/) {
+        return !(begin <= 42 && 42 < end);
+    };
+    EXPECT_FALSE(scheduler.run("fail", 100, func));
+
+    auto succeed = [&](size_t, size_t, int) {return true;};
+    EXPECT_TRUE(scheduler.run("succeed", 100, succeed));
+    EXPECT_TRUE(scheduler.run("empty", 0, succeed));
+    scheduler.stop();
+    EXPECT_TRUE(scheduler.run("stopped", 100, succeed));
+}
@@ -39,11 +39,21 @@
 #include <iostream>
 #include <string>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
 #include <chrono> // NOLINT
+#include <cmath>
+#include <condition_variable> // NOLINT
 #include <ctime>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <map>
+#include <mutex> // NOLINT
 #include <sstream>
 #include <cstdlib>
+#include <thread> // NOLINT
+#include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/tokenizer.hpp>
@@ -57,14 +67,154 @@ using std::cout;
 using std::endl;
 
 void usage(char *argv[]) {
-    cout << endl << "Usage: " << argv[0] << " -d ~/.scrimmage/logs"
+    cout << endl << "Usage: " << argv[0] << " ~/.scrimmage/logs [num_threads]"
          << endl << endl;
 }
 
+// Finds the summary.csv files under root. The directories are listed by
+// num_threads threads that share a stack of directories left to list.
+std::vector<std::string> find_summaries(const fs::path &root, unsigned int num_threads) {
+    const std::string summary_csv = "summary.csv";
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<fs::path> dirs = {root};
+    unsigned int busy = 0;
+    std::vector<std::vector<std::string>> found(num_threads);
+
+    auto worker = [&](unsigned int id) {
+        std::vector<fs::path> subdirs;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            // done once no directory is left and no thread can add one
+            cv.wait(lock, [&]() {return !dirs.empty() || busy == 0;});
+            if (dirs.empty()) break;
+
+            fs::path dir = std::move(dirs.back());
+            dirs.pop_back();
+            busy++;
+            lock.unlock();
+
+            subdirs.clear();
+            boost::system::error_code ec;
+            for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                // like recursive_directory_iterator, don't follow symlinks to directories
+                if (fs::is_directory(it->symlink_status())) {
+                    subdirs.push_back(it->path());
+                } else if (it->path().filename() == summary_csv &&
+                           fs::is_regular_file(it->status())) {
+                    found[id].push_back(fs::absolute(it->path()).string());
+                }
+            }
+
+            lock.lock();
+            dirs.insert(dirs.end(), subdirs.begin(), subdirs.end());
+            busy--;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; i++) {
+        threads.emplace_back(worker, i);
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::string> paths;
+    for (std::vector<std::string> &f : found) {
+        paths.insert(paths.end(), f.begin(), f.end());
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// Reads the scores of a summary.csv into team_scores. The file is read into
+// buf, which is reused between files, and the fields are parsed in place.
+// Lines that don't start with a team id and a score are skipped.
+bool read_scores(const std::string &filename, std::string &buf,
+                 std::map<int, double> &team_scores) {
+    std::ifstream csv_file(filename, std::ios::binary | std::ios::ate);
+    if (!csv_file.is_open()) return false;
+
+    const std::streamoff size = csv_file.tellg();
+    if (size < 0) return false;
+    buf.resize(size);
+    csv_file.seekg(0);
+    if (!csv_file.read(&buf[0], size)) return false;
+
+    team_scores.clear();
+    const char *p = buf.c_str();
+    const char *end = p + buf.size();
+
+    // skip header comment
+    const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    p = eol ? eol + 1 : end;
+
+    while (p < end) {
+        eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (eol == nullptr) eol = end;
+
+        // strtol and strtod stop at the comma after a field, but skip leading
+        // whitespace, so check that they didn't run into the next line
+        char *field_end;
+        const long team_id = std::strtol(p, &field_end, 10);
+        if (field_end != p && field_end < eol && *field_end == ',') {
+            const char *score_begin = field_end + 1;
+            const double score = std::strtod(score_begin, &field_end);
+            if (field_end != score_begin && field_end <= eol) {
+                team_scores[static_cast<int>(team_id)] = score;
+            }
+        }
+        p = eol + 1;
+    }
+    return true;
+}
+
+// The wins and draws counted by one thread
+struct Tally {
+    std::map<int, int> team_wins;
+    std::map<int, int> team_draws;
+};
+
+// Returns the name of the result file of a run, or an empty string if the
+// winner couldn't be determined
+std::string run_result(const std::map<int, double> &team_scores, Tally &tally) {
+    // Determine which teams lost, won, and drew
+    double max_score = -std::numeric_limits<double>::infinity();
+    std::vector<int> winning_team;
+    for (auto &kv : team_scores) {
+        if (std::abs(kv.second-max_score) < 0.000001) {
+            // A possible draw
+            winning_team.push_back(kv.first);
+        } else if (kv.second > max_score) {
+            max_score = kv.second;
+            winning_team.clear();
+            winning_team.push_back(kv.first);
+        }
+    }
+
+    std::string result_filename = "";
+    if (winning_team.size() == 1) {
+        // One winner, write a win file
+        result_filename = "team_" + std::to_string(winning_team[0]);
+        tally.team_wins[winning_team[0]] += 1;
+    } else if (winning_team.size() > 1) {
+        // Draw for multiple winners
+        result_filename = "draw";
+        for (auto &team : winning_team) {
+            result_filename += "_" + std::to_string(team);
+            tally.team_draws[team] += 1;
+        }
+    }
+    return result_filename;
+}
+
 int main(int argc, char *argv[]) {
 
     if (argc < 2) {
-        cout << "usage: " << argv[0] << " <directory of filter results>" << endl;
+        cout << "usage: " << argv[0] << " <directory of filter results> [num_threads]" << endl;
         return -1;
     }
 
@@ -77,21 +227,16 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
+    unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 2) {
+        num_threads = std::max(1, std::atoi(argv[2]));
+    }
+
     // Find all summary.csv files under the directory
     std::vector<std::string> paths;
     fs::path root = log_dir;
-    std::string summary_csv = "summary.csv";
     if (fs::exists(root) && fs::is_directory(root)) {
-        fs::recursive_directory_iterator it(root);
-        fs::recursive_directory_iterator endit;
-
-        while (it != endit) {
-            if (fs::is_regular_file(*it) && it->path().filename() == summary_csv) {
-                std::string full_path = fs::absolute(it->path()).string();
-                paths.push_back(full_path);
-            }
-            ++it;
-        }
+        paths = find_summaries(root, num_threads);
     } else {
         cout << "Path doesn't exist: " << log_dir << endl;
     }
@@ -114,92 +259,83 @@ int main(int argc, char *argv[]) {
     int number_of_runs = paths.size();
     cout << "Aggregating " << number_of_runs << " runs. " << endl;
 
-    int count = 0;
-    std::map<int, int> team_wins;
-    std::map<int, int> team_draws;
-
-    std::clock_t start = std::clock();
+    auto start = std::chrono::steady_clock::now();
     std::ofstream summary_file(log_dir + "/aggregate/all_runs.csv");
 
-    // Using the score from each summary_csv, keep track of team wins
-    for (std::string &filename : paths) {
-        if (!fs::exists(fs::path(filename))) {
-            cout << "summary.csv doesn't exist: " << filename << endl;
-            return -1;
-        }
-
-        std::ifstream csv_file(filename);
-
-        std::string line;
-        std::getline(csv_file, line); // skip header comment
-
+    // Using the score from each summary_csv, keep track of team wins. The
+    // threads take runs from a shared counter and count the wins and draws
+    // in their own tallies. The result of run i is stored in results[i].
+    std::vector<std::string> results(paths.size());
+    std::vector<Tally> tallies(num_threads);
+    std::atomic<size_t> next_run(0);
+    std::atomic<int> count(0);
+    std::atomic<bool> missing(false);
+
+    auto worker = [&](unsigned int id) {
+        Tally &tally = tallies[id];
+        std::string buf;
         std::map<int, double> team_scores;
-        while (std::getline(csv_file, line)) {
-            std::vector<std::string> t;
-            boost::split(t, line, boost::is_any_of(","));
-
-            int team_id = std::stoi(t[0]);
-            team_scores[team_id] = std::stod(t[1]);
-        }
-
-        // Determine which teams lost, won, and drew
-        double max_score = -std::numeric_limits<double>::infinity();
-        std::vector<int> winning_team;
-        for (auto &kv : team_scores) {
-            if (std::abs(kv.second-max_score) < 0.000001) {
-                // A possible draw
-                winning_team.push_back(kv.first);
-            } else if (kv.second > max_score) {
-                max_score = kv.second;
-                winning_team.clear();
-                winning_team.push_back(kv.first);
+        size_t i;
+        while (!missing && (i = next_run++) < paths.size()) {
+            const std::string &filename = paths[i];
+            if (!read_scores(filename, buf, team_scores)) {
+                if (!fs::exists(fs::path(filename))) {
+                    cout << "summary.csv doesn't exist: " << filename << endl;
+                    missing = true;
+                    break;
+                }
+                team_scores.clear();
             }
-        }
 
-        std::string result_filename = "";
-        if (winning_team.size() == 0) {
-            cout << "Warning: Couldn't determine winner of: " << filename << endl;
-            continue;
-        } else if (winning_team.size() == 1) {
-            result_filename = "team_" + std::to_string(winning_team[0]);
-            // One winner, write a win file
-            if (team_wins.count(winning_team[0]) > 0) {
-                team_wins[winning_team[0]] += 1;
-            } else {
-                team_wins[winning_team[0]] = 1;
-            }
-        } else if (winning_team.size() > 1) {
-            // Draw for multiple winners
-            result_filename = "draw";
-            for (auto &team : winning_team) {
-                result_filename += "_" + std::to_string(team);
-
-                if (team_draws.count(team) > 0) {
-                    team_draws[team] += 1;
-                } else {
-                    team_draws[team] = 1;
-                }
+            results[i] = run_result(team_scores, tally);
+            if (results[i].empty()) {
+                cout << "Warning: Couldn't determine winner of: " << filename << endl;
+                continue;
             }
-        } else {
-            cout << "Warning" << endl;
+            count++;
         }
+    };
 
-        result_filename = output_dir + "/" + result_filename + ".result";
-
-        // Write log directory to file
-        std::ofstream result_file;
-        result_file.open(result_filename, std::ios::out | std::ios::app);
-
-        // Write the parent directory of this specific simulation to the file.
-        result_file << fs::path(filename).parent_path().string() << endl;
-        result_file.close();
-
-        count++;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < num_threads; i++) {
+        threads.emplace_back(worker, i);
+    }
+    while (next_run < paths.size() && !missing) {
+        scrimmage::display_progress(count / static_cast<float>(number_of_runs));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    if (missing) return -1;
+    if (number_of_runs > 0) {
         scrimmage::display_progress(count / static_cast<float>(number_of_runs));
     }
     cout << endl;
 
-    double duration = (std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+    std::map<int, int> team_wins;
+    std::map<int, int> team_draws;
+    for (Tally &tally : tallies) {
+        for (auto &kv : tally.team_wins) team_wins[kv.first] += kv.second;
+        for (auto &kv : tally.team_draws) team_draws[kv.first] += kv.second;
+    }
+
+    // Write the parent directory of each simulation to its result file,
+    // opening each file once
+    std::map<std::string, std::ofstream> result_files;
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (results[i].empty()) continue;
+        auto it = result_files.find(results[i]);
+        if (it == result_files.end()) {
+            std::string result_filename = output_dir + "/" + results[i] + ".result";
+            it = result_files.emplace(results[i], std::ofstream(result_filename)).first;
+        }
+        it->second << fs::path(paths[i]).parent_path().string() << '\n';
+    }
+    result_files.clear();
+
+    double duration = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
     cout << "Total time to process log files: " << duration << endl;
 
     // Make a map of the available team ids, so we can loop over it while